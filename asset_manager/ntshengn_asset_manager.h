@@ -1,19 +1,47 @@
 #pragma once
 #include "../module_interfaces/ntshengn_asset_loader_module_interface.h"
+#include "../job_system/ntshengn_job_system.h"
 #include "../resources/ntshengn_resources_audio.h"
 #include "../resources/ntshengn_resources_graphics.h"
 #include "../utils/ntshengn_defines.h"
 #include "../utils/ntshengn_utils_bimap.h"
+#include "../utils/ntshengn_utils_compression.h"
+#include "../utils/ntshengn_utils_concurrent_hash_map.h"
 #include "../utils/ntshengn_utils_file.h"
 #include "../utils/ntshengn_utils_json.h"
+#include "../utils/ntshengn_utils_mapped_file.h"
+#include "../utils/ntshengn_utils_slot_map.h"
 #include "../utils/ntshengn_utils_math.h"
+#include "../utils/ntshengn_utils_mesh_optimizer.h"
+#include "../utils/ntshengn_utils_mesh_simplifier.h"
+#include "../utils/ntshengn_utils_meshlet_builder.h"
+#include "../utils/ntshengn_utils_quantization.h"
 #include <string>
-#include <forward_list>
 #include <iterator>
 #include <cmath>
 #include <array>
 #include <utility>
 #include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstddef>
+#include <future>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+#include <list>
+#include <limits>
+#include <type_traits>
+#include <system_error>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
 
 #if defined(NTSHENGN_DEBUG)
 #define NTSHENGN_ASSET_MANAGER_INFO(message) \
@@ -52,13 +80,29 @@
 
 namespace NtshEngn {
 
+	struct AssetCacheStats {
+		// Loads that found the resource already loaded
+		uint64_t hits = 0;
+
+		// Loads that had to read the file
+		uint64_t misses = 0;
+
+		// Unreferenced resources destroyed to stay within the memory budget
+		uint64_t evictions = 0;
+
+		// Approximate memory used by the resources loaded from files
+		size_t memoryUsage = 0;
+
+		// Number of resources loaded from files
+		size_t resourceCount = 0;
+	};
+
 	class AssetManager {
 	public:
 		Sound* createSound() {
-			Sound newSound;
-			m_soundResources.push_front(newSound);
+			std::unique_lock<std::mutex> lock(getCache<Sound>().mutex);
 
-			return &m_soundResources.front();
+			return m_soundResources.get(m_soundResources.insert(Sound()));
 		}
 
 		Sound* loadSound(const std::string& filePath) {
@@ -68,26 +112,28 @@ namespace NtshEngn {
 				return nullptr;
 			}
 
-			if (m_soundPaths.exist(filePath)) {
-				return m_soundPaths[filePath];
+			if (Sound* loadedSound = findLoadedResource<Sound>(filePath)) {
+				return loadedSound;
 			}
 			
 			Sound newSound;
-			if (File::extension(filePath) == "ntsd") {
-				loadSoundNtsd(filePath, newSound);
-			}
-			else {
-				if (m_assetLoaderModule) {
-					newSound = m_assetLoaderModule->loadSound(filePath);
+			const std::string cacheKey = getCacheKey("sound", filePath);
+			if (!loadFromCache(cacheKey, filePath, newSound)) {
+				if (File::extension(filePath) == "ntsd") {
+					loadSoundNtsd(filePath, newSound);
+				}
+				else {
+					if (m_assetLoaderModule) {
+						newSound = m_assetLoaderModule->loadSound(filePath);
+					}
+				}
+				if (newSound.size != 0) {
+					writeToCache(cacheKey, filePath, newSound);
 				}
 			}
 
 			if (newSound.size != 0) {
-				m_soundResources.push_front(newSound);
-
-				m_soundPaths.insert_or_assign(filePath, &m_soundResources.front());
-
-				return &m_soundResources.front();
+				return addResource(filePath, std::move(newSound));
 			}
 			else {
 				NTSHENGN_ASSET_MANAGER_WARNING("Could not load sound file \"" + filePath + "\".");
@@ -97,11 +143,9 @@ namespace NtshEngn {
 		}
 
 		Model* createModel() {
-			Model newModel;
+			std::unique_lock<std::mutex> lock(getCache<Model>().mutex);
 
-			m_modelResources.push_front(newModel);
-
-			return &m_modelResources.front();
+			return m_modelResources.get(m_modelResources.insert(Model()));
 		}
 
 		Model* loadModel(const std::string& filePath) {
@@ -111,277 +155,2744 @@ namespace NtshEngn {
 				return nullptr;
 			}
 
-			if (m_modelPaths.exist(filePath)) {
-				return m_modelPaths[filePath];
+			if (Model* loadedModel = findLoadedResource<Model>(filePath)) {
+				return loadedModel;
 			}
 
 			Model newModel;
-			if (File::extension(filePath) == "ntmd") {
+			const std::string extension = File::extension(filePath);
+			if (extension == "ntmd") {
 				loadModelNtmd(filePath, newModel);
+				generateModelLODs(newModel);
+			}
+			else if ((extension == "ntmh") || (extension == "ntmb")) {
+				ModelPrimitive primitive;
+				loadMesh(filePath, primitive.mesh);
+				if (!primitive.mesh.vertices.empty()) {
+					newModel.primitives.push_back(primitive);
+				}
+				generateModelLODs(newModel);
 			}
 			else {
-				if (m_assetLoaderModule) {
+				// .ntmd models are not cached as a whole as their meshes and images are
+				const std::string cacheKey = getCacheKey(getMeshCacheType("model") + ((m_lodCount != 0) ? ("LOD" + std::to_string(m_lodCount)) : ""), filePath);
+				if (!loadFromCache(cacheKey, filePath, newModel) && m_assetLoaderModule) {
 					newModel = m_assetLoaderModule->loadModel(filePath);
+					for (ModelPrimitive& primitive : newModel.primitives) {
+						processLoadedMesh(primitive.mesh);
+					}
+					generateModelLODs(newModel);
+					if (newModel.primitives.size() != 0) {
+						writeToCache(cacheKey, filePath, newModel);
+					}
 				}
 			}
 
 			if (newModel.primitives.size() != 0) {
-				m_modelResources.push_front(newModel);
-
-				m_modelPaths.insert_or_assign(filePath, &m_modelResources.front());
+				for (ModelPrimitive& primitive : newModel.primitives) {
+					updateMeshBounds(primitive.mesh);
+				}
+				trackCreatedModelImages(newModel);
 
-				return &m_modelResources.front();
+				return addResource(filePath, std::move(newModel));
 			}
 			else {
 				NTSHENGN_ASSET_MANAGER_WARNING("Could not load model file \"" + filePath + "\".");
 
-				return nullptr;
+				return nullptr;
+			}
+		}
+
+		Image* createImage() {
+			std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+			return m_imageResources.get(m_imageResources.insert(Image()));
+		}
+
+		Image* loadImage(const std::string& filePath) {
+			if (!std::filesystem::exists(filePath)) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Could not load image file \"" + filePath + "\" (file does not exist).");
+
+				return nullptr;
+			}
+
+			if (Image* loadedImage = findLoadedResource<Image>(filePath)) {
+				return loadedImage;
+			}
+
+			Image newImage;
+			const std::string cacheKey = getCacheKey("image", filePath);
+			if (!loadFromCache(cacheKey, filePath, newImage)) {
+				if (File::extension(filePath) == "ntim") {
+					loadImageNtim(filePath, newImage);
+				}
+				else {
+					if (m_assetLoaderModule) {
+						newImage = m_assetLoaderModule->loadImage(filePath);
+					}
+				}
+				// Binary .ntim files are already in the cached form
+				if (!m_cacheDirectory.empty() && (newImage.width != 0) && !isImageNtimBinary(filePath)) {
+					writeToCache(cacheKey, filePath, newImage);
+				}
+			}
+
+			if (newImage.width != 0) {
+				return addResource(filePath, std::move(newImage));
+			}
+			else {
+				NTSHENGN_ASSET_MANAGER_WARNING("Could not load image file \"" + filePath + "\".");
+
+				return nullptr;
+			}
+		}
+
+		Font* createFont() {
+			std::unique_lock<std::mutex> lock(getCache<Font>().mutex);
+
+			return m_fontResources.get(m_fontResources.insert(Font()));
+		}
+
+		Font* loadFont(const std::string& filePath, float fontHeight) {
+			if (!std::filesystem::exists(filePath)) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Could not load font file \"" + filePath + "\" (file does not exist).");
+
+				return nullptr;
+			}
+
+			if (fontHeight <= 0.0f) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Font height for font file \"" + filePath + "\" should be greater than 0.");
+
+				return nullptr;
+			}
+
+			const std::string fontKey = filePath + "/" + std::to_string(fontHeight);
+			if (Font* loadedFont = findLoadedResource<Font>(fontKey)) {
+				return loadedFont;
+			}
+
+			Font newFont;
+			const std::string cacheKey = getCacheKey("font", fontKey);
+			if (!loadFromCache(cacheKey, filePath, newFont) && m_assetLoaderModule) {
+				newFont = m_assetLoaderModule->loadFont(filePath, fontHeight);
+				if (newFont.image) {
+					writeToCache(cacheKey, filePath, newFont);
+				}
+			}
+
+			if (newFont.image) {
+				return addResource(fontKey, std::move(newFont));
+			}
+			else {
+				NTSHENGN_ASSET_MANAGER_WARNING("Could not load font file \"" + filePath + "\".");
+
+				return nullptr;
+			}
+		}
+
+		// Asynchronous loads run on the job system's workers when one is set, and synchronously otherwise
+		// Concurrent requests for the same file share the same future, which holds nullptr if the load failed
+		std::shared_future<Sound*> loadSoundAsync(const std::string& filePath) {
+			return loadAsync<Sound>(filePath, m_pendingSoundLoads, [this, filePath]() {
+				return loadSound(filePath);
+			});
+		}
+
+		std::shared_future<Model*> loadModelAsync(const std::string& filePath) {
+			return loadAsync<Model>(filePath, m_pendingModelLoads, [this, filePath]() {
+				return loadModel(filePath);
+			});
+		}
+
+		std::shared_future<Image*> loadImageAsync(const std::string& filePath) {
+			return loadAsync<Image>(filePath, m_pendingImageLoads, [this, filePath]() {
+				return loadImage(filePath);
+			});
+		}
+
+		std::shared_future<Font*> loadFontAsync(const std::string& filePath, float fontHeight) {
+			return loadAsync<Font>(filePath + "/" + std::to_string(fontHeight), m_pendingFontLoads, [this, filePath, fontHeight]() {
+				return loadFont(filePath, fontHeight);
+			});
+		}
+
+		// Resources loaded from files are reference counted, each successful load, synchronous or not, takes a reference that is given back with release
+		// Unreferenced resources stay loaded for later loads of the same file until their type's memory budget is exceeded, the least recently released are then destroyed
+		// Resources made with create* are not reference counted and are never evicted, except images created for a loaded model, which the model references, and a loaded font's image, destroyed with the font
+		template <typename T>
+		void retain(T* resource) {
+			std::unique_lock<std::mutex> lock(getCache<T>().mutex);
+
+			retainLocked(resource);
+		}
+
+		template <typename T>
+		void release(T* resource) {
+			std::unique_lock<std::mutex> lock(getCache<T>().mutex);
+
+			releaseLocked(resource);
+		}
+
+		// Memory allowed for the unreferenced resources of type T to stay loaded, unlimited by default
+		template <typename T>
+		void setMemoryBudget(size_t memoryBudget) {
+			std::unique_lock<std::mutex> lock(getCache<T>().mutex);
+
+			getCache<T>().memoryBudget = memoryBudget;
+			evictLocked<T>();
+		}
+
+		template <typename T>
+		AssetCacheStats getCacheStats() {
+			std::unique_lock<std::mutex> lock(getCache<T>().mutex);
+
+			return getCache<T>().stats;
+		}
+
+		// Owns one reference on a resource and gives it back when destroyed, copies take their own reference
+		template <typename T>
+		class Reference {
+		public:
+			Reference() = default;
+
+			// Adopts a reference already held on resource, such as the one taken by a load
+			Reference(AssetManager* assetManager, T* resource) : m_assetManager(assetManager), m_resource(resource) {}
+
+			Reference(const Reference& other) : m_assetManager(other.m_assetManager), m_resource(other.m_resource) {
+				if (m_resource) {
+					m_assetManager->retain(m_resource);
+				}
+			}
+
+			Reference(Reference&& other) noexcept : m_assetManager(other.m_assetManager), m_resource(std::exchange(other.m_resource, nullptr)) {}
+
+			Reference& operator=(Reference other) noexcept {
+				std::swap(m_assetManager, other.m_assetManager);
+				std::swap(m_resource, other.m_resource);
+
+				return *this;
+			}
+
+			~Reference() {
+				reset();
+			}
+
+			void reset() {
+				if (m_resource) {
+					m_assetManager->release(m_resource);
+					m_resource = nullptr;
+				}
+			}
+
+			T* get() const {
+				return m_resource;
+			}
+
+			T* operator->() const {
+				return m_resource;
+			}
+
+			T& operator*() const {
+				return *m_resource;
+			}
+
+			explicit operator bool() const {
+				return m_resource != nullptr;
+			}
+
+		private:
+			AssetManager* m_assetManager = nullptr;
+			T* m_resource = nullptr;
+		};
+
+		// Waits for an asynchronous load, the calling thread executes the loads of the same type no worker started yet meanwhile so that it can be called from inside a job
+		// No other job runs on the waiting thread's stack, loads never wait for a load of their own type so they cannot wait for the waiting thread
+		template <typename T>
+		T* waitForLoad(const std::shared_future<T*>& future) {
+			while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				if (!m_jobSystem || !runPendingLoad<T>()) {
+					std::this_thread::yield();
+				}
+			}
+
+			return future.get();
+		}
+
+		void destroySound(Sound* sound) {
+			std::unique_lock<std::mutex> lock(getCache<Sound>().mutex);
+
+			const Handle<Sound> handle = m_soundResources.getHandle(sound);
+			if (!m_soundResources.exist(handle)) {
+				NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy sound resource.", Result::AssetManagerError);
+			}
+
+			if (m_soundPaths.exist(sound)) {
+				m_soundPaths.erase(sound);
+			}
+			untrackResourceLocked(sound);
+			m_soundResources.erase(handle);
+		}
+
+		void destroySound(Handle<Sound> handle) {
+			std::unique_lock<std::mutex> lock(getCache<Sound>().mutex);
+
+			Sound* sound = m_soundResources.get(handle);
+			if (!sound) {
+				NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy sound resource.", Result::AssetManagerError);
+			}
+
+			if (m_soundPaths.exist(sound)) {
+				m_soundPaths.erase(sound);
+			}
+			untrackResourceLocked(sound);
+			m_soundResources.erase(handle);
+		}
+
+		// Invalid handle if sound is not a resource of this asset manager
+		Handle<Sound> getSoundHandle(const Sound* sound) {
+			std::unique_lock<std::mutex> lock(getCache<Sound>().mutex);
+
+			return m_soundResources.getHandle(sound);
+		}
+
+		// Returns nullptr if the resource has been destroyed
+		Sound* getSound(Handle<Sound> handle) {
+			std::unique_lock<std::mutex> lock(getCache<Sound>().mutex);
+
+			return m_soundResources.get(handle);
+		}
+
+		// Calls function on every sound resource, function must not create or destroy resources
+		void forEachSound(const std::function<void(Handle<Sound>, Sound&)>& function) {
+			std::unique_lock<std::mutex> lock(getCache<Sound>().mutex);
+
+			m_soundResources.for_each(function);
+		}
+
+		void destroyModel(Model* model) {
+			std::unique_lock<std::mutex> lock(getCache<Model>().mutex);
+
+			const Handle<Model> handle = m_modelResources.getHandle(model);
+			if (!m_modelResources.exist(handle)) {
+				NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy model resource.", Result::AssetManagerError);
+			}
+
+			if (m_modelPaths.exist(model)) {
+				m_modelPaths.erase(model);
+			}
+			untrackResourceLocked(model);
+			m_modelResources.erase(handle);
+		}
+
+		void destroyModel(Handle<Model> handle) {
+			std::unique_lock<std::mutex> lock(getCache<Model>().mutex);
+
+			Model* model = m_modelResources.get(handle);
+			if (!model) {
+				NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy model resource.", Result::AssetManagerError);
+			}
+
+			if (m_modelPaths.exist(model)) {
+				m_modelPaths.erase(model);
+			}
+			untrackResourceLocked(model);
+			m_modelResources.erase(handle);
+		}
+
+		// Invalid handle if model is not a resource of this asset manager
+		Handle<Model> getModelHandle(const Model* model) {
+			std::unique_lock<std::mutex> lock(getCache<Model>().mutex);
+
+			return m_modelResources.getHandle(model);
+		}
+
+		// Returns nullptr if the resource has been destroyed
+		Model* getModel(Handle<Model> handle) {
+			std::unique_lock<std::mutex> lock(getCache<Model>().mutex);
+
+			return m_modelResources.get(handle);
+		}
+
+		// Calls function on every model resource, function must not create or destroy resources
+		void forEachModel(const std::function<void(Handle<Model>, Model&)>& function) {
+			std::unique_lock<std::mutex> lock(getCache<Model>().mutex);
+
+			m_modelResources.for_each(function);
+		}
+
+		void destroyImage(Image* image) {
+			std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+			const Handle<Image> handle = m_imageResources.getHandle(image);
+			if (!m_imageResources.exist(handle)) {
+				NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy image resource.", Result::AssetManagerError);
+			}
+
+			if (m_imagePaths.exist(image)) {
+				m_imagePaths.erase(image);
+			}
+			untrackResourceLocked(image);
+			m_imageResources.erase(handle);
+		}
+
+		void destroyImage(Handle<Image> handle) {
+			std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+			Image* image = m_imageResources.get(handle);
+			if (!image) {
+				NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy image resource.", Result::AssetManagerError);
+			}
+
+			if (m_imagePaths.exist(image)) {
+				m_imagePaths.erase(image);
+			}
+			untrackResourceLocked(image);
+			m_imageResources.erase(handle);
+		}
+
+		// Invalid handle if image is not a resource of this asset manager
+		Handle<Image> getImageHandle(const Image* image) {
+			std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+			return m_imageResources.getHandle(image);
+		}
+
+		// Returns nullptr if the resource has been destroyed
+		Image* getImage(Handle<Image> handle) {
+			std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+			return m_imageResources.get(handle);
+		}
+
+		// Calls function on every image resource, function must not create or destroy resources
+		void forEachImage(const std::function<void(Handle<Image>, Image&)>& function) {
+			std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+			m_imageResources.for_each(function);
+		}
+
+		void destroyFont(Font* font) {
+			std::unique_lock<std::mutex> lock(getCache<Font>().mutex);
+
+			const Handle<Font> handle = m_fontResources.getHandle(font);
+			if (!m_fontResources.exist(handle)) {
+				NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy font resource.", Result::AssetManagerError);
+			}
+
+			if (m_fontPaths.exist(font)) {
+				m_fontPaths.erase(font);
+			}
+			untrackResourceLocked(font);
+			m_fontResources.erase(handle);
+		}
+
+		void destroyFont(Handle<Font> handle) {
+			std::unique_lock<std::mutex> lock(getCache<Font>().mutex);
+
+			Font* font = m_fontResources.get(handle);
+			if (!font) {
+				NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy font resource.", Result::AssetManagerError);
+			}
+
+			if (m_fontPaths.exist(font)) {
+				m_fontPaths.erase(font);
+			}
+			untrackResourceLocked(font);
+			m_fontResources.erase(handle);
+		}
+
+		// Invalid handle if font is not a resource of this asset manager
+		Handle<Font> getFontHandle(const Font* font) {
+			std::unique_lock<std::mutex> lock(getCache<Font>().mutex);
+
+			return m_fontResources.getHandle(font);
+		}
+
+		// Returns nullptr if the resource has been destroyed
+		Font* getFont(Handle<Font> handle) {
+			std::unique_lock<std::mutex> lock(getCache<Font>().mutex);
+
+			return m_fontResources.get(handle);
+		}
+
+		// Calls function on every font resource, function must not create or destroy resources
+		void forEachFont(const std::function<void(Handle<Font>, Font&)>& function) {
+			std::unique_lock<std::mutex> lock(getCache<Font>().mutex);
+
+			m_fontResources.for_each(function);
+		}
+
+		void calculateTangents(Mesh& mesh) {
+			if (m_assetLoaderModule) {
+				m_assetLoaderModule->calculateTangents(mesh);
+			}
+			else {
+				NTSHENGN_ASSET_MANAGER_WARNING("Could not calculate tangent for mesh.");
+			}
+		}
+
+		// Always calculated from the vertices, large meshes are processed in parallel when a job system is set
+		std::array<Math::vec3, 2> calculateAABB(const Mesh& mesh) {
+			const std::array<Math::vec3, 2> emptyAABB = { Math::vec3(std::numeric_limits<float>::max()), Math::vec3(std::numeric_limits<float>::lowest()) };
+			const std::array<Math::vec3, 2> aabb = reduceVertices<std::array<Math::vec3, 2>>(mesh, emptyAABB, calculatePositionAABB, [](const std::array<Math::vec3, 2>& a, const std::array<Math::vec3, 2>& b) {
+				return std::array<Math::vec3, 2>{ Math::vec3(std::min(a[0].x, b[0].x), std::min(a[0].y, b[0].y), std::min(a[0].z, b[0].z)), Math::vec3(std::max(a[1].x, b[1].x), std::max(a[1].y, b[1].y), std::max(a[1].z, b[1].z)) };
+			});
+			Math::vec3 min = aabb[0];
+			Math::vec3 max = aabb[1];
+
+			const float epsilon = 0.0001f;
+
+			if (min.x == max.x) {
+				min.x -= epsilon;
+				max.x += epsilon;
+			}
+
+			if (min.y == max.y) {
+				min.y -= epsilon;
+				max.y += epsilon;
+			}
+
+			if (min.z == max.z) {
+				min.z -= epsilon;
+				max.z += epsilon;
+			}
+
+			return { Math::vec3(min.x, min.y, min.z), Math::vec3(max.x, max.y, max.z) };
+		}
+
+		// Ritter's bounding sphere, started from the most distant pair of extreme vertices along the axes, as a center and a radius
+		// Always calculated from the vertices, large meshes are processed in parallel when a job system is set
+		std::pair<Math::vec3, float> calculateBoundingSphere(const Mesh& mesh) {
+			if (mesh.vertices.empty()) {
+				return { Math::vec3(0.0f), 0.0f };
+			}
+
+			// Vertices with the smallest and largest x, y and z
+			const Math::vec3 firstPosition = mesh.vertices[0].position;
+			const std::array<Math::vec3, 6> extremePositions = reduceVertices<std::array<Math::vec3, 6>>(mesh, { firstPosition, firstPosition, firstPosition, firstPosition, firstPosition, firstPosition }, [](const Vertex* vertices, size_t vertexCount) {
+				std::array<Math::vec3, 6> extremes = { vertices[0].position, vertices[0].position, vertices[0].position, vertices[0].position, vertices[0].position, vertices[0].position };
+				for (size_t i = 1; i < vertexCount; i++) {
+					const Math::vec3& position = vertices[i].position;
+					if (position.x < extremes[0].x) {
+						extremes[0] = position;
+					}
+					if (position.x > extremes[1].x) {
+						extremes[1] = position;
+					}
+					if (position.y < extremes[2].y) {
+						extremes[2] = position;
+					}
+					if (position.y > extremes[3].y) {
+						extremes[3] = position;
+					}
+					if (position.z < extremes[4].z) {
+						extremes[4] = position;
+					}
+					if (position.z > extremes[5].z) {
+						extremes[5] = position;
+					}
+				}
+
+				return extremes;
+			}, mergeExtremePositions);
+
+			std::pair<Math::vec3, float> initialSphere = { firstPosition, 0.0f };
+			float maxDiameter = -1.0f;
+			for (size_t i = 0; i < 3; i++) {
+				const float diameter = (extremePositions[(i * 2) + 1] - extremePositions[i * 2]).length();
+				if (diameter > maxDiameter) {
+					maxDiameter = diameter;
+					initialSphere = { (extremePositions[i * 2] + extremePositions[(i * 2) + 1]) / 2.0f, diameter / 2.0f };
+				}
+			}
+
+			// Each chunk grows the initial sphere over its vertices, the resulting spheres are then merged
+			return reduceVertices<std::pair<Math::vec3, float>>(mesh, { Math::vec3(0.0f), -1.0f }, [&initialSphere](const Vertex* vertices, size_t vertexCount) {
+				Math::vec3 center = initialSphere.first;
+				float radius = initialSphere.second;
+				for (size_t i = 0; i < vertexCount; i++) {
+					const Math::vec3 offset = vertices[i].position - center;
+					const float squaredDistance = Math::dot(offset, offset);
+					if (squaredDistance > (radius * radius)) {
+						const float distance = std::sqrt(squaredDistance);
+						const float newRadius = (radius + distance) / 2.0f;
+						center += offset * ((newRadius - radius) / distance);
+						radius = newRadius;
+					}
+				}
+
+				return std::pair<Math::vec3, float>{ center, radius };
+			}, mergeBoundingSpheres);
+		}
+
+		// Stores the AABB and bounding sphere in mesh.bounds so that getMeshBounds does not calculate them again
+		void updateMeshBounds(Mesh& mesh) {
+			const std::array<Math::vec3, 2> aabb = calculateAABB(mesh);
+			const std::pair<Math::vec3, float> boundingSphere = calculateBoundingSphere(mesh);
+			mesh.bounds.aabbMin = aabb[0];
+			mesh.bounds.aabbMax = aabb[1];
+			mesh.bounds.boundingSphereCenter = boundingSphere.first;
+			mesh.bounds.boundingSphereRadius = boundingSphere.second;
+			mesh.bounds.valid = true;
+		}
+
+		// Returns the stored bounds when they are valid, calculated ones otherwise
+		// Meshes of loaded models have valid bounds, they are stale if their positions changed since and valid was not reset
+		MeshBounds getMeshBounds(const Mesh& mesh) {
+			if (mesh.bounds.valid) {
+				return mesh.bounds;
+			}
+
+			const std::array<Math::vec3, 2> aabb = calculateAABB(mesh);
+			const std::pair<Math::vec3, float> boundingSphere = calculateBoundingSphere(mesh);
+			MeshBounds bounds;
+			bounds.aabbMin = aabb[0];
+			bounds.aabbMax = aabb[1];
+			bounds.boundingSphereCenter = boundingSphere.first;
+			bounds.boundingSphereRadius = boundingSphere.second;
+
+			return bounds;
+		}
+
+		static uint32_t getVertexAttributeFormatSize(VertexAttributeFormat format) {
+			switch (format) {
+			case VertexAttributeFormat::Float32x2:
+				return 2 * sizeof(float);
+
+			case VertexAttributeFormat::Float32x3:
+				return 3 * sizeof(float);
+
+			case VertexAttributeFormat::Float32x4:
+			case VertexAttributeFormat::Uint32x4:
+				return 4 * sizeof(float);
+
+			case VertexAttributeFormat::Float16x4:
+			case VertexAttributeFormat::Snorm16x4:
+			case VertexAttributeFormat::Unorm16x4:
+			case VertexAttributeFormat::Uint16x4:
+				return 4 * sizeof(uint16_t);
+
+			case VertexAttributeFormat::Float16x2:
+			case VertexAttributeFormat::Octahedral16x2:
+			case VertexAttributeFormat::Snorm8x4:
+			case VertexAttributeFormat::Unorm8x4:
+			case VertexAttributeFormat::Uint8x4:
+				return 4 * sizeof(uint8_t);
+
+			default:
+				return 0;
+			}
+		}
+
+		static bool isVertexAttributeFormatSupported(VertexAttribute attribute, VertexAttributeFormat format) {
+			switch (attribute) {
+			case VertexAttribute::Position:
+				return (format == VertexAttributeFormat::Float32x3) || (format == VertexAttributeFormat::Float16x4);
+
+			case VertexAttribute::Normal:
+				return (format == VertexAttributeFormat::None) || (format == VertexAttributeFormat::Float32x3) || (format == VertexAttributeFormat::Octahedral16x2) || (format == VertexAttributeFormat::Snorm16x4) || (format == VertexAttributeFormat::Snorm8x4);
+
+			case VertexAttribute::UV:
+				return (format == VertexAttributeFormat::None) || (format == VertexAttributeFormat::Float32x2) || (format == VertexAttributeFormat::Float16x2);
+
+			case VertexAttribute::Color:
+				return (format == VertexAttributeFormat::None) || (format == VertexAttributeFormat::Float32x3) || (format == VertexAttributeFormat::Float16x4) || (format == VertexAttributeFormat::Unorm16x4) || (format == VertexAttributeFormat::Unorm8x4);
+
+			case VertexAttribute::Tangent:
+				return (format == VertexAttributeFormat::None) || (format == VertexAttributeFormat::Float32x4) || (format == VertexAttributeFormat::Float16x4) || (format == VertexAttributeFormat::Snorm16x4) || (format == VertexAttributeFormat::Snorm8x4);
+
+			case VertexAttribute::Joints:
+				return (format == VertexAttributeFormat::None) || (format == VertexAttributeFormat::Uint32x4) || (format == VertexAttributeFormat::Uint16x4) || (format == VertexAttributeFormat::Uint8x4);
+
+			case VertexAttribute::Weights:
+				return (format == VertexAttributeFormat::None) || (format == VertexAttributeFormat::Float32x4) || (format == VertexAttributeFormat::Float16x4) || (format == VertexAttributeFormat::Unorm16x4) || (format == VertexAttributeFormat::Unorm8x4);
+
+			default:
+				return false;
+			}
+		}
+
+		// Calculates the offsets and the stride of a layout storing each attribute in its format
+		static VertexLayout createVertexLayout(const std::array<VertexAttributeFormat, static_cast<size_t>(VertexAttribute::Count)>& formats) {
+			VertexLayout vertexLayout;
+			vertexLayout.formats = formats;
+			vertexLayout.stride = 0;
+			for (size_t i = 0; i < formats.size(); i++) {
+				vertexLayout.offsets[i] = vertexLayout.stride;
+				vertexLayout.stride += getVertexAttributeFormatSize(formats[i]);
+			}
+
+			return vertexLayout;
+		}
+
+		// Smallest layout holding mesh, attributes that are zero for every vertex are not stored
+		// When quantize is true, normals are octahedral, UVs are half floats, colors and tangents are 8-bit, joints are 8-bit when they fit and weights are 16-bit
+		static VertexLayout getCompactVertexLayout(const Mesh& mesh, bool quantize = true) {
+			bool hasNormal = false;
+			bool hasUV = false;
+			bool hasColor = false;
+			bool hasTangent = false;
+			bool hasJoints = false;
+			bool hasWeights = false;
+			bool hasUnitColor = true;
+			uint32_t maxJoint = 0;
+			for (const Vertex& vertex : mesh.vertices) {
+				hasNormal |= (vertex.normal.x != 0.0f) || (vertex.normal.y != 0.0f) || (vertex.normal.z != 0.0f);
+				hasUV |= (vertex.uv.x != 0.0f) || (vertex.uv.y != 0.0f);
+				hasColor |= (vertex.color.x != 0.0f) || (vertex.color.y != 0.0f) || (vertex.color.z != 0.0f);
+				hasTangent |= (vertex.tangent.x != 0.0f) || (vertex.tangent.y != 0.0f) || (vertex.tangent.z != 0.0f) || (vertex.tangent.w != 0.0f);
+				hasJoints |= (vertex.joints[0] != 0) || (vertex.joints[1] != 0) || (vertex.joints[2] != 0) || (vertex.joints[3] != 0);
+				hasWeights |= (vertex.weights.x != 0.0f) || (vertex.weights.y != 0.0f) || (vertex.weights.z != 0.0f) || (vertex.weights.w != 0.0f);
+				hasUnitColor &= (vertex.color.x >= 0.0f) && (vertex.color.x <= 1.0f) && (vertex.color.y >= 0.0f) && (vertex.color.y <= 1.0f) && (vertex.color.z >= 0.0f) && (vertex.color.z <= 1.0f);
+				maxJoint = std::max({ maxJoint, vertex.joints[0], vertex.joints[1], vertex.joints[2], vertex.joints[3] });
+			}
+
+			std::array<VertexAttributeFormat, static_cast<size_t>(VertexAttribute::Count)> formats;
+			formats[static_cast<size_t>(VertexAttribute::Position)] = VertexAttributeFormat::Float32x3;
+			if (quantize) {
+				formats[static_cast<size_t>(VertexAttribute::Normal)] = hasNormal ? VertexAttributeFormat::Octahedral16x2 : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::UV)] = hasUV ? VertexAttributeFormat::Float16x2 : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::Color)] = hasColor ? (hasUnitColor ? VertexAttributeFormat::Unorm8x4 : VertexAttributeFormat::Float16x4) : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::Tangent)] = hasTangent ? VertexAttributeFormat::Snorm8x4 : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::Joints)] = hasJoints ? ((maxJoint <= std::numeric_limits<uint8_t>::max()) ? VertexAttributeFormat::Uint8x4 : ((maxJoint <= std::numeric_limits<uint16_t>::max()) ? VertexAttributeFormat::Uint16x4 : VertexAttributeFormat::Uint32x4)) : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::Weights)] = hasWeights ? VertexAttributeFormat::Unorm16x4 : VertexAttributeFormat::None;
+			}
+			else {
+				formats[static_cast<size_t>(VertexAttribute::Normal)] = hasNormal ? VertexAttributeFormat::Float32x3 : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::UV)] = hasUV ? VertexAttributeFormat::Float32x2 : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::Color)] = hasColor ? VertexAttributeFormat::Float32x3 : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::Tangent)] = hasTangent ? VertexAttributeFormat::Float32x4 : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::Joints)] = hasJoints ? VertexAttributeFormat::Uint32x4 : VertexAttributeFormat::None;
+				formats[static_cast<size_t>(VertexAttribute::Weights)] = hasWeights ? VertexAttributeFormat::Float32x4 : VertexAttributeFormat::None;
+			}
+
+			return createVertexLayout(formats);
+		}
+
+		// Packs mesh's vertices following vertexLayout, returns false if an attribute's format is not supported for it
+		// Quantized weights are adjusted so that they still sum to 1
+		bool packMesh(const Mesh& mesh, const VertexLayout& vertexLayout, PackedMesh& packedMesh) {
+			for (size_t i = 0; i < vertexLayout.formats.size(); i++) {
+				if (!isVertexAttributeFormatSupported(static_cast<VertexAttribute>(i), vertexLayout.formats[i])) {
+					NTSHENGN_ASSET_MANAGER_WARNING("Vertex layout uses an unsupported format for attribute " + std::to_string(i) + ", could not pack mesh.");
+
+					return false;
+				}
+			}
+
+			packedMesh.vertexLayout = vertexLayout;
+			packedMesh.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+			packedMesh.vertices.assign(static_cast<size_t>(vertexLayout.stride) * mesh.vertices.size(), 0);
+			for (size_t i = 0; i < vertexLayout.formats.size(); i++) {
+				const VertexAttribute attribute = static_cast<VertexAttribute>(i);
+				const VertexAttributeFormat format = vertexLayout.formats[i];
+				if (format == VertexAttributeFormat::None) {
+					continue;
+				}
+
+				uint8_t* destination = packedMesh.vertices.data() + vertexLayout.offsets[i];
+				for (const Vertex& vertex : mesh.vertices) {
+					if (attribute == VertexAttribute::Joints) {
+						encodeVertexJoints(format, vertex.joints, destination);
+					}
+					else {
+						std::array<float, 4> values = getVertexAttributeValues(vertex, attribute);
+						if ((attribute == VertexAttribute::Weights) && ((format == VertexAttributeFormat::Unorm8x4) || (format == VertexAttributeFormat::Unorm16x4))) {
+							encodeVertexWeights(format, values, destination);
+						}
+						else {
+							encodeVertexAttribute(format, values, destination);
+						}
+					}
+					destination += vertexLayout.stride;
+				}
+			}
+
+			uint32_t maxIndex = 0;
+			for (uint32_t index : mesh.indices) {
+				maxIndex = std::max(maxIndex, index);
+			}
+			packedMesh.indexSize = (maxIndex <= std::numeric_limits<uint16_t>::max()) ? sizeof(uint16_t) : sizeof(uint32_t);
+			packedMesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+			packedMesh.indices.resize(static_cast<size_t>(packedMesh.indexSize) * mesh.indices.size());
+			if (packedMesh.indexSize == sizeof(uint16_t)) {
+				for (size_t i = 0; i < mesh.indices.size(); i++) {
+					const uint16_t index = static_cast<uint16_t>(mesh.indices[i]);
+					std::memcpy(packedMesh.indices.data() + (i * sizeof(uint16_t)), &index, sizeof(uint16_t));
+				}
+			}
+			else if (!mesh.indices.empty()) {
+				std::memcpy(packedMesh.indices.data(), mesh.indices.data(), packedMesh.indices.size());
+			}
+
+			packedMesh.skin = mesh.skin;
+			packedMesh.topology = mesh.topology;
+
+			return true;
+		}
+
+		// Attributes that are not stored in the packed mesh are zero
+		void unpackMesh(const PackedMesh& packedMesh, Mesh& mesh) {
+			const VertexLayout& vertexLayout = packedMesh.vertexLayout;
+			mesh.vertices.assign(packedMesh.vertexCount, Vertex());
+			for (size_t i = 0; i < vertexLayout.formats.size(); i++) {
+				const VertexAttribute attribute = static_cast<VertexAttribute>(i);
+				const VertexAttributeFormat format = vertexLayout.formats[i];
+				if (format == VertexAttributeFormat::None) {
+					continue;
+				}
+
+				const uint8_t* source = packedMesh.vertices.data() + vertexLayout.offsets[i];
+				for (Vertex& vertex : mesh.vertices) {
+					if (attribute == VertexAttribute::Joints) {
+						vertex.joints = decodeVertexJoints(format, source);
+					}
+					else {
+						setVertexAttributeValues(vertex, attribute, decodeVertexAttribute(format, source));
+					}
+					source += vertexLayout.stride;
+				}
+			}
+
+			mesh.indices.resize(packedMesh.indexCount);
+			if (packedMesh.indexSize == sizeof(uint16_t)) {
+				for (size_t i = 0; i < mesh.indices.size(); i++) {
+					uint16_t index;
+					std::memcpy(&index, packedMesh.indices.data() + (i * sizeof(uint16_t)), sizeof(uint16_t));
+					mesh.indices[i] = index;
+				}
+			}
+			else if (!mesh.indices.empty()) {
+				std::memcpy(mesh.indices.data(), packedMesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+			}
+
+			mesh.skin = packedMesh.skin;
+			mesh.topology = packedMesh.topology;
+		}
+
+		// Replaces primitive's LODs with up to lodCount simplifications of its mesh, each with about half the triangles of the previous one
+		// A LOD's screen size is where its simplification error, relative to the primitive's size, covers screenError of the screen height
+		void generateLODs(ModelPrimitive& primitive, uint32_t lodCount, float screenError = 0.001f) {
+			primitive.lods.clear();
+			if ((primitive.mesh.topology != MeshTopology::TriangleList) || primitive.mesh.indices.empty()) {
+				return;
+			}
+
+			size_t previousIndexCount = primitive.mesh.indices.size();
+			float previousScreenSize = 1.0f;
+			for (uint32_t i = 0; i < lodCount; i++) {
+				ModelPrimitiveLOD lod;
+				float error;
+				lod.indices = MeshSimplifier::simplify(primitive.mesh, (previousIndexCount / 6) * 3, LOD_MAX_ERROR, &error);
+				// Stop once the mesh cannot be simplified much further
+				if (lod.indices.empty() || ((lod.indices.size() * 10) > (previousIndexCount * 9))) {
+					break;
+				}
+
+				lod.screenSize = (error > 0.0f) ? std::min(screenError / error, previousScreenSize) : previousScreenSize;
+				previousIndexCount = lod.indices.size();
+				previousScreenSize = lod.screenSize;
+				primitive.lods.push_back(std::move(lod));
+			}
+		}
+
+		// Writes mesh in the binary .ntmb format, attributes that are zero for every vertex are not stored
+		bool writeMeshNtmb(const Mesh& mesh, const std::string& filePath, bool compress = true) {
+			std::vector<uint8_t> fileData;
+			serializeMeshNtmb(mesh, compress, fileData);
+
+			std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Could not open mesh file \"" + filePath + "\" for writing.");
+
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+
+			return file.good();
+		}
+
+		// Converts a .ntmh mesh file to a .ntmb mesh file, tangents calculated while loading are stored
+		bool convertMeshNtmhToNtmb(const std::string& ntmhFilePath, const std::string& ntmbFilePath, bool compress = true) {
+			Mesh mesh;
+			loadMeshNtmh(ntmhFilePath, mesh);
+			if (mesh.vertices.empty()) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Could not convert mesh file \"" + ntmhFilePath + "\" (no vertices).");
+
+				return false;
+			}
+
+			return writeMeshNtmb(mesh, ntmbFilePath, compress);
+		}
+
+		// Size in bytes of a width x height image, 0 for ImageFormat::Unknown
+		static size_t getImageMipLevelSize(ImageFormat format, uint32_t width, uint32_t height) {
+			size_t blockSize = 1;
+			size_t bytesPerBlock = 0;
+			switch (format) {
+			case ImageFormat::R8:
+				bytesPerBlock = 1;
+				break;
+
+			case ImageFormat::R8G8:
+				bytesPerBlock = 2;
+				break;
+
+			case ImageFormat::R8G8B8:
+				bytesPerBlock = 3;
+				break;
+
+			case ImageFormat::R8G8B8A8:
+				bytesPerBlock = 4;
+				break;
+
+			case ImageFormat::R16:
+				bytesPerBlock = 2;
+				break;
+
+			case ImageFormat::R16G16:
+				bytesPerBlock = 4;
+				break;
+
+			case ImageFormat::R16G16B16:
+				bytesPerBlock = 6;
+				break;
+
+			case ImageFormat::R16G16B16A16:
+				bytesPerBlock = 8;
+				break;
+
+			case ImageFormat::R32:
+				bytesPerBlock = 4;
+				break;
+
+			case ImageFormat::R32G32:
+				bytesPerBlock = 8;
+				break;
+
+			case ImageFormat::R32G32B32:
+				bytesPerBlock = 12;
+				break;
+
+			case ImageFormat::R32G32B32A32:
+				bytesPerBlock = 16;
+				break;
+
+			case ImageFormat::BC1RGB:
+			case ImageFormat::BC1RGBA:
+			case ImageFormat::BC4R:
+				blockSize = 4;
+				bytesPerBlock = 8;
+				break;
+
+			case ImageFormat::BC3RGBA:
+			case ImageFormat::BC5RG:
+			case ImageFormat::BC6HRGBUFloat:
+			case ImageFormat::BC7RGBA:
+				blockSize = 4;
+				bytesPerBlock = 16;
+				break;
+
+			default:
+				break;
+			}
+
+			return ((static_cast<size_t>(width) + blockSize - 1) / blockSize) * ((static_cast<size_t>(height) + blockSize - 1) / blockSize) * bytesPerBlock;
+		}
+
+		// Size in bytes of the first mipLevelCount mip levels of a width x height image
+		static size_t getImageDataSize(ImageFormat format, uint32_t width, uint32_t height, uint32_t mipLevelCount) {
+			size_t size = 0;
+			for (uint32_t mipLevel = 0; mipLevel < mipLevelCount; mipLevel++) {
+				size += getImageMipLevelSize(format, std::max(width >> mipLevel, 1u), std::max(height >> mipLevel, 1u));
+			}
+
+			return size;
+		}
+
+		static uint32_t getImageMaxMipLevelCount(uint32_t width, uint32_t height) {
+			uint32_t mipLevelCount = 1;
+			while ((std::max(width, height) >> mipLevelCount) != 0) {
+				mipLevelCount++;
+			}
+
+			return mipLevelCount;
+		}
+
+		// Replaces the mip levels of an 8-bit per channel image by a full chain, each level is a 2x2 box filter of the previous one, done in linear space for sRGB color channels
+		void generateImageMipmaps(Image& image) {
+			uint32_t channelCount = 0;
+			switch (image.format) {
+			case ImageFormat::R8:
+				channelCount = 1;
+				break;
+
+			case ImageFormat::R8G8:
+				channelCount = 2;
+				break;
+
+			case ImageFormat::R8G8B8:
+				channelCount = 3;
+				break;
+
+			case ImageFormat::R8G8B8A8:
+				channelCount = 4;
+				break;
+
+			default:
+				NTSHENGN_ASSET_MANAGER_WARNING("Mipmaps can only be generated for 8-bit per channel image formats.");
+
+				return;
+			}
+
+			std::array<float, 256> toLinear;
+			for (size_t i = 0; i < toLinear.size(); i++) {
+				const float value = static_cast<float>(i) / 255.0f;
+				toLinear[i] = (image.colorSpace == ImageColorSpace::SRGB) ? ((value <= 0.04045f) ? (value / 12.92f) : std::pow((value + 0.055f) / 1.055f, 2.4f)) : value;
+			}
+			const auto fromLinear = [&image](float value) {
+				if (image.colorSpace == ImageColorSpace::SRGB) {
+					value = (value <= 0.0031308f) ? (value * 12.92f) : ((1.055f * std::pow(value, 1.0f / 2.4f)) - 0.055f);
+				}
+
+				return static_cast<uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+			};
+			// Alpha is never sRGB encoded
+			const uint32_t colorChannelCount = (channelCount == 4) ? 3 : channelCount;
+
+			// Mapped data is read-only
+			if (image.mappedFile) {
+				image.data.assign(image.getData(), image.getData() + image.getDataSize());
+				image.mappedFile.reset();
+				image.mappedData = nullptr;
+				image.mappedDataSize = 0;
+			}
+
+			image.mipLevelCount = getImageMaxMipLevelCount(image.width, image.height);
+			image.data.resize(getImageDataSize(image.format, image.width, image.height, image.mipLevelCount));
+
+			size_t sourceOffset = 0;
+			for (uint32_t mipLevel = 1; mipLevel < image.mipLevelCount; mipLevel++) {
+				const uint32_t sourceWidth = std::max(image.width >> (mipLevel - 1), 1u);
+				const uint32_t sourceHeight = std::max(image.height >> (mipLevel - 1), 1u);
+				const uint32_t width = std::max(image.width >> mipLevel, 1u);
+				const uint32_t height = std::max(image.height >> mipLevel, 1u);
+				const size_t destinationOffset = sourceOffset + getImageMipLevelSize(image.format, sourceWidth, sourceHeight);
+
+				const uint8_t* source = image.data.data() + sourceOffset;
+				uint8_t* destination = image.data.data() + destinationOffset;
+				for (uint32_t y = 0; y < height; y++) {
+					const size_t y0 = std::min(y * 2, sourceHeight - 1);
+					const size_t y1 = std::min((y * 2) + 1, sourceHeight - 1);
+					for (uint32_t x = 0; x < width; x++) {
+						const size_t x0 = std::min(x * 2, sourceWidth - 1);
+						const size_t x1 = std::min((x * 2) + 1, sourceWidth - 1);
+						const uint8_t* texels[4] = {
+							source + (((y0 * sourceWidth) + x0) * channelCount),
+							source + (((y0 * sourceWidth) + x1) * channelCount),
+							source + (((y1 * sourceWidth) + x0) * channelCount),
+							source + (((y1 * sourceWidth) + x1) * channelCount)
+						};
+						for (uint32_t channel = 0; channel < channelCount; channel++) {
+							if (channel < colorChannelCount) {
+								const float sum = toLinear[texels[0][channel]] + toLinear[texels[1][channel]] + toLinear[texels[2][channel]] + toLinear[texels[3][channel]];
+								destination[channel] = fromLinear(sum * 0.25f);
+							}
+							else {
+								destination[channel] = static_cast<uint8_t>((static_cast<uint32_t>(texels[0][channel]) + texels[1][channel] + texels[2][channel] + texels[3][channel] + 2) / 4);
+							}
+						}
+						destination += channelCount;
+					}
+				}
+
+				sourceOffset = destinationOffset;
+			}
+		}
+
+		// Writes image in the binary .ntim format
+		bool writeImageNtim(const Image& image, const std::string& filePath, bool compress = false) {
+			std::vector<uint8_t> fileData;
+			if (!serializeImageNtim(image, compress, fileData)) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Image data size does not match its size, format and mip level count, could not write image file \"" + filePath + "\".");
+
+				return false;
+			}
+
+			std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Could not open image file \"" + filePath + "\" for writing.");
+
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+
+			return file.good();
+		}
+
+	public:
+		void setAssetLoaderModule(AssetLoaderModuleInterface* assetLoaderModule) {
+			m_assetLoaderModule = assetLoaderModule;
+		}
+
+		// The asset manager must outlive the asynchronous loads it started
+		void setJobSystem(JobSystem* jobSystem) {
+			m_jobSystem = jobSystem;
+		}
+
+		// When enabled, uncompressed binary .ntim images and cached images keep their data in the memory-mapped file (Image::mappedFile) instead of copying it into Image::data
+		void setImageFileMapping(bool mapImageFiles) {
+			m_mapImageFiles = mapImageFiles;
+		}
+
+		// When enabled, loaded meshes are welded and reordered for the vertex cache, overdraw and vertex fetch (MeshOptimizer::optimize), cached meshes and models are stored optimized
+		void setMeshOptimization(bool optimizeMeshes) {
+			m_optimizeMeshes = optimizeMeshes;
+		}
+
+		// When not 0, loaded models get up to lodCount LODs per primitive (generateLODs), cached models are stored with them
+		void setLODGeneration(uint32_t lodCount) {
+			m_lodCount = lodCount;
+		}
+
+		// When enabled, loaded meshes are split in meshlets (MeshletBuilder::build) after being optimized, cached meshes and models are stored with them
+		void setMeshletGeneration(bool buildMeshlets) {
+			m_buildMeshlets = buildMeshlets;
+		}
+
+		// Forgets the parsed samplers and materials
+		void clearMaterialCache() {
+			m_materialCache.clear();
+			m_imageSamplerCache.clear();
+		}
+
+		// Sounds, .ntmh meshes, images, fonts and models loaded by the asset loader module are stored in cacheDirectory in their loaded binary form
+		// Later loads read the cache entry instead of parsing the source file again as long as the source file is unchanged, an empty directory disables the cache
+		void setCacheDirectory(const std::string& cacheDirectory) {
+			m_cacheDirectory = cacheDirectory;
+			if (!m_cacheDirectory.empty()) {
+				std::error_code error;
+				std::filesystem::create_directories(m_cacheDirectory, error);
+				if (error) {
+					NTSHENGN_ASSET_MANAGER_WARNING("Could not create cache directory \"" + m_cacheDirectory + "\", assets will not be cached.");
+					m_cacheDirectory.clear();
+				}
+			}
+		}
+
+	private:
+		struct ResourceUsage {
+			uint32_t referenceCount = 0;
+			size_t memorySize = 0;
+		};
+
+		// Each resource type has its own lock guarding its resources, paths and cache, so that loads of different types do not contend
+		// A type's lock can be held while taking the images' lock, never the other way around
+		template <typename T>
+		struct ResourceCache {
+			std::mutex mutex;
+
+			std::unordered_map<const T*, ResourceUsage> usages;
+
+			// Unreferenced resources, the most recently released first
+			std::list<T*> unusedResources;
+			std::unordered_map<const T*, typename std::list<T*>::iterator> unusedPositions;
+
+			size_t memoryBudget = std::numeric_limits<size_t>::max();
+			AssetCacheStats stats;
+		};
+
+		template <typename T>
+		struct PendingLoad {
+			std::shared_future<T*> future;
+
+			// The load is the only job of this group, so that waitForLoad can run it without running other jobs
+			std::shared_ptr<JobCounter> counter;
+
+			// Each request for the same file gets its own reference once the load is done
+			uint32_t requestCount = 1;
+		};
+
+		template <typename T>
+		SlotMap<T>& getResources() {
+			if constexpr (std::is_same_v<T, Sound>) {
+				return m_soundResources;
+			}
+			else if constexpr (std::is_same_v<T, Model>) {
+				return m_modelResources;
+			}
+			else if constexpr (std::is_same_v<T, Image>) {
+				return m_imageResources;
+			}
+			else {
+				return m_fontResources;
+			}
+		}
+
+		template <typename T>
+		std::unordered_map<std::string, PendingLoad<T>>& getPendingLoads() {
+			if constexpr (std::is_same_v<T, Sound>) {
+				return m_pendingSoundLoads;
+			}
+			else if constexpr (std::is_same_v<T, Model>) {
+				return m_pendingModelLoads;
+			}
+			else if constexpr (std::is_same_v<T, Image>) {
+				return m_pendingImageLoads;
+			}
+			else {
+				return m_pendingFontLoads;
+			}
+		}
+
+		template <typename T>
+		Bimap<std::string, T*>& getPaths() {
+			if constexpr (std::is_same_v<T, Sound>) {
+				return m_soundPaths;
+			}
+			else if constexpr (std::is_same_v<T, Model>) {
+				return m_modelPaths;
+			}
+			else if constexpr (std::is_same_v<T, Image>) {
+				return m_imagePaths;
+			}
+			else {
+				return m_fontPaths;
+			}
+		}
+
+		template <typename T>
+		ResourceCache<T>& getCache() {
+			if constexpr (std::is_same_v<T, Sound>) {
+				return m_soundCache;
+			}
+			else if constexpr (std::is_same_v<T, Model>) {
+				return m_modelCache;
+			}
+			else if constexpr (std::is_same_v<T, Image>) {
+				return m_imageCache;
+			}
+			else {
+				return m_fontCache;
+			}
+		}
+
+		static size_t getResourceMemorySize(const Sound& sound) {
+			return sizeof(Sound) + sound.data.size();
+		}
+
+		static size_t getResourceMemorySize(const Model& model) {
+			size_t memorySize = sizeof(Model);
+			for (const ModelPrimitive& primitive : model.primitives) {
+				memorySize += sizeof(ModelPrimitive) + (primitive.mesh.vertices.size() * sizeof(Vertex)) + (primitive.mesh.indices.size() * sizeof(uint32_t));
+				for (const ModelPrimitiveLOD& lod : primitive.lods) {
+					memorySize += sizeof(ModelPrimitiveLOD) + (lod.indices.size() * sizeof(uint32_t));
+				}
+				memorySize += (primitive.mesh.meshlets.size() * sizeof(Meshlet)) + (primitive.mesh.meshletVertices.size() * sizeof(uint32_t)) + primitive.mesh.meshletTriangles.size();
+			}
+
+			return memorySize;
+		}
+
+		// Mapped data is counted as it gets paged in when used
+		static size_t getResourceMemorySize(const Image& image) {
+			return sizeof(Image) + image.getDataSize();
+		}
+
+		static size_t getResourceMemorySize(const Font& font) {
+			return sizeof(Font) + (font.glyphs.size() * sizeof(std::pair<const char, FontGlyph>));
+		}
+
+		// Returns the resource loaded from key with a new reference on it, or nullptr if it is not loaded
+		template <typename T>
+		T* findLoadedResource(const std::string& key) {
+			std::unique_lock<std::mutex> lock(getCache<T>().mutex);
+
+			Bimap<std::string, T*>& paths = getPaths<T>();
+			if (!paths.exist(key)) {
+				getCache<T>().stats.misses++;
+
+				return nullptr;
+			}
+
+			T* resource = paths[key];
+			getCache<T>().stats.hits++;
+			retainLocked(resource);
+
+			return resource;
+		}
+
+		// Registers a loaded resource under key with a reference on it, or returns the resource already registered under key if another thread loaded it in the meantime
+		template <typename T>
+		T* addResource(const std::string& key, T&& resource) {
+			std::unique_lock<std::mutex> lock(getCache<T>().mutex);
+
+			Bimap<std::string, T*>& paths = getPaths<T>();
+			if (paths.exist(key)) {
+				T* loadedResource = paths[key];
+				retainLocked(loadedResource);
+
+				// The resource loaded by this thread is dropped, with the references on images it holds
+				if constexpr (std::is_same_v<T, Model>) {
+					for (const ModelPrimitive& primitive : resource.primitives) {
+						releaseMaterialImages(primitive.material);
+					}
+				}
+				else if constexpr (std::is_same_v<T, Font>) {
+					if (resource.image) {
+						destroyImage(resource.image);
+					}
+				}
+
+				return loadedResource;
+			}
+
+			SlotMap<T>& resources = getResources<T>();
+			T* newResource = resources.get(resources.insert(std::move(resource)));
+			paths.insert_or_assign(key, newResource);
+
+			ResourceCache<T>& cache = getCache<T>();
+			ResourceUsage usage;
+			usage.referenceCount = 1;
+			usage.memorySize = getResourceMemorySize(*newResource);
+			cache.usages.insert({ newResource, usage });
+			cache.stats.memoryUsage += usage.memorySize;
+			cache.stats.resourceCount++;
+			evictLocked<T>();
+
+			return newResource;
+		}
+
+		template <typename T>
+		void retainLocked(T* resource) {
+			ResourceCache<T>& cache = getCache<T>();
+			typename std::unordered_map<const T*, ResourceUsage>::iterator it = cache.usages.find(resource);
+			if (it == cache.usages.end()) {
+				return;
+			}
+
+			if (it->second.referenceCount == 0) {
+				cache.unusedResources.erase(cache.unusedPositions[resource]);
+				cache.unusedPositions.erase(resource);
+			}
+			it->second.referenceCount++;
+		}
+
+		template <typename T>
+		void releaseLocked(T* resource) {
+			ResourceCache<T>& cache = getCache<T>();
+			typename std::unordered_map<const T*, ResourceUsage>::iterator it = cache.usages.find(resource);
+			if (it == cache.usages.end()) {
+				return;
+			}
+
+			if (it->second.referenceCount == 0) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Released a resource that has no reference left.");
+
+				return;
+			}
+
+			it->second.referenceCount--;
+			if (it->second.referenceCount == 0) {
+				cache.unusedResources.push_front(resource);
+				cache.unusedPositions.insert({ resource, cache.unusedResources.begin() });
+				evictLocked<T>();
+			}
+		}
+
+		// Destroys the least recently released resources until the memory budget is met or no resource is unreferenced
+		template <typename T>
+		void evictLocked() {
+			ResourceCache<T>& cache = getCache<T>();
+			while ((cache.stats.memoryUsage > cache.memoryBudget) && !cache.unusedResources.empty()) {
+				T* resource = cache.unusedResources.back();
+
+				Bimap<std::string, T*>& paths = getPaths<T>();
+				if (paths.exist(resource)) {
+					paths.erase(resource);
+				}
+				untrackResourceLocked(resource);
+				getResources<T>().erase(getResources<T>().getHandle(resource));
+				cache.stats.evictions++;
+			}
+		}
+
+		// Forgets the reference count of a resource about to be destroyed, a model gives back the references on its images
+		template <typename T>
+		void untrackResourceLocked(T* resource) {
+			ResourceCache<T>& cache = getCache<T>();
+			typename std::unordered_map<const T*, ResourceUsage>::iterator it = cache.usages.find(resource);
+			if (it == cache.usages.end()) {
+				return;
+			}
+
+			if (it->second.referenceCount == 0) {
+				cache.unusedResources.erase(cache.unusedPositions[resource]);
+				cache.unusedPositions.erase(resource);
+			}
+			cache.stats.memoryUsage -= it->second.memorySize;
+			cache.stats.resourceCount--;
+			cache.usages.erase(it);
+
+			if constexpr (std::is_same_v<T, Model>) {
+				for (const ModelPrimitive& primitive : resource->primitives) {
+					releaseMaterialImages(primitive.material);
+				}
+			}
+			else if constexpr (std::is_same_v<T, Font>) {
+				// The atlas was created for the font when it was loaded
+				if (resource->image) {
+					destroyImage(resource->image);
+				}
+			}
+		}
+
+		// Images created with createImage for a loaded model are reference counted like loaded images, with one reference per texture using them that the model gives back
+		void trackCreatedModelImages(const Model& model) {
+			std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+			ResourceCache<Image>& cache = getCache<Image>();
+			std::unordered_map<Image*, uint32_t> createdImageReferences;
+			for (const ModelPrimitive& primitive : model.primitives) {
+				for (const Texture* texture : getMaterialTextures(primitive.material)) {
+					if (texture->image && (cache.usages.find(texture->image) == cache.usages.end())) {
+						createdImageReferences[texture->image]++;
+					}
+				}
+			}
+
+			for (const std::pair<Image* const, uint32_t>& createdImage : createdImageReferences) {
+				ResourceUsage usage;
+				usage.referenceCount = createdImage.second;
+				usage.memorySize = getResourceMemorySize(*createdImage.first);
+				cache.usages.insert({ createdImage.first, usage });
+				cache.stats.memoryUsage += usage.memorySize;
+				cache.stats.resourceCount++;
+			}
+		}
+
+		// Locks the images, callers may hold the models' lock
+		void releaseMaterialImages(const Material& material) {
+			std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+			for (const Texture* texture : getMaterialTextures(material)) {
+				if (texture->image) {
+					releaseLocked(texture->image);
+				}
+			}
+		}
+
+		template <typename T>
+		std::shared_future<T*> loadAsync(const std::string& key, std::unordered_map<std::string, PendingLoad<T>>& pendingLoads, const std::function<T*()>& load) {
+			std::unique_lock<std::mutex> lock(m_pendingLoadsMutex);
+
+			typename std::unordered_map<std::string, PendingLoad<T>>::iterator it = pendingLoads.find(key);
+			if (it != pendingLoads.end()) {
+				it->second.requestCount++;
+
+				return it->second.future;
+			}
+
+			// std::function needs a copyable job, the promise is shared
+			std::shared_ptr<std::promise<T*>> promise = std::make_shared<std::promise<T*>>();
+			std::shared_future<T*> future = promise->get_future().share();
+			if (!m_jobSystem) {
+				lock.unlock();
+				promise->set_value(load());
+
+				return future;
+			}
+
+			PendingLoad<T> pendingLoad;
+			pendingLoad.future = future;
+			pendingLoad.counter = std::make_shared<JobCounter>();
+			pendingLoads.insert({ key, pendingLoad });
+			lock.unlock();
+
+			// The job keeps the counter alive until it is done
+			const std::shared_ptr<JobCounter> counter = pendingLoad.counter;
+			m_jobSystem->execute([this, key, promise, load, &pendingLoads, counter]() {
+				T* asset = load();
+				uint32_t requestCount;
+				{
+					std::unique_lock<std::mutex> pendingLoadsLock(m_pendingLoadsMutex);
+
+					requestCount = pendingLoads[key].requestCount;
+					pendingLoads.erase(key);
+				}
+				if (asset) {
+					std::unique_lock<std::mutex> resourcesLock(getCache<T>().mutex);
+
+					for (uint32_t i = 1; i < requestCount; i++) {
+						retainLocked(asset);
+					}
+				}
+				promise->set_value(asset);
+			}, *counter);
+
+			return future;
+		}
+
+		// Waits for the asynchronous load of key, the calling thread runs that load if no worker started it yet
+		template <typename T>
+		T* waitForLoad(const std::string& key, const std::shared_future<T*>& future) {
+			while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				if (!m_jobSystem || !runPendingLoad<T>(&key)) {
+					std::this_thread::yield();
+				}
+			}
+
+			return future.get();
+		}
+
+		// Runs the asynchronous load of key, or any load of type T if key is nullptr, that no worker started yet, returns false if there was none
+		template <typename T>
+		bool runPendingLoad(const std::string* key = nullptr) {
+			std::vector<std::shared_ptr<JobCounter>> counters;
+			{
+				std::unique_lock<std::mutex> lock(m_pendingLoadsMutex);
+
+				std::unordered_map<std::string, PendingLoad<T>>& pendingLoads = getPendingLoads<T>();
+				if (key) {
+					typename std::unordered_map<std::string, PendingLoad<T>>::iterator it = pendingLoads.find(*key);
+					if (it != pendingLoads.end()) {
+						counters.push_back(it->second.counter);
+					}
+				}
+				else {
+					for (const std::pair<const std::string, PendingLoad<T>>& pendingLoad : pendingLoads) {
+						counters.push_back(pendingLoad.second.counter);
+					}
+				}
+			}
+
+			for (const std::shared_ptr<JobCounter>& counter : counters) {
+				if (m_jobSystem->runGroupJob(*counter)) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// Binary mesh file layout, little-endian:
+		// MeshNtmbHeader
+		// Positions then each attribute present in attributeMask, in NTMB_ATTRIBUTES order, as one tightly packed stream of vertexCount values
+		// Indices, indexCount uint32_t
+		// With LZ4 compression, everything after the header is a single LZ4 block of dataSize bytes
+		struct MeshNtmbHeader {
+			char magic[4];
+			uint32_t version;
+			uint32_t vertexCount;
+			uint32_t indexCount;
+			uint32_t topology;
+			uint32_t attributeMask;
+			uint32_t compression;
+			uint32_t padding = 0;
+			uint64_t dataSize;
+			uint64_t uncompressedDataSize;
+		};
+
+		struct MeshNtmbAttribute {
+			uint32_t bit;
+			size_t offset;
+			size_t size;
+		};
+
+		static constexpr char NTMB_MAGIC[4] = { 'N', 'T', 'M', 'B' };
+		static constexpr uint32_t NTMB_VERSION = 1;
+
+		static constexpr uint32_t NTMB_NORMAL = 1 << 0;
+		static constexpr uint32_t NTMB_UV = 1 << 1;
+		static constexpr uint32_t NTMB_COLOR = 1 << 2;
+		static constexpr uint32_t NTMB_TANGENT = 1 << 3;
+		static constexpr uint32_t NTMB_JOINTS = 1 << 4;
+		static constexpr uint32_t NTMB_WEIGHTS = 1 << 5;
+
+		static constexpr uint32_t NTMB_COMPRESSION_NONE = 0;
+		static constexpr uint32_t NTMB_COMPRESSION_LZ4 = 1;
+
+		static constexpr MeshNtmbAttribute NTMB_ATTRIBUTES[6] = {
+			{ NTMB_NORMAL, offsetof(Vertex, normal), 3 * sizeof(float) },
+			{ NTMB_UV, offsetof(Vertex, uv), 2 * sizeof(float) },
+			{ NTMB_COLOR, offsetof(Vertex, color), 3 * sizeof(float) },
+			{ NTMB_TANGENT, offsetof(Vertex, tangent), 4 * sizeof(float) },
+			{ NTMB_JOINTS, offsetof(Vertex, joints), 4 * sizeof(uint32_t) },
+			{ NTMB_WEIGHTS, offsetof(Vertex, weights), 4 * sizeof(float) }
+		};
+
+		// Binary image file layout, little-endian:
+		// ImageNtimHeader
+		// Mip levels from the largest to the smallest, tightly packed rows of pixels or of 4x4 blocks for block compressed formats
+		// With LZ4 compression, everything after the header is a single LZ4 block of dataSize bytes
+		struct ImageNtimHeader {
+			char magic[4];
+			uint32_t version;
+			uint32_t width;
+			uint32_t height;
+			uint32_t format;
+			uint32_t colorSpace;
+			uint32_t mipLevelCount;
+			uint32_t compression;
+			uint64_t dataSize;
+			uint64_t uncompressedDataSize;
+		};
+
+		static constexpr char NTIM_MAGIC[4] = { 'N', 'T', 'I', 'M' };
+		static constexpr uint32_t NTIM_VERSION = 1;
+
+		static constexpr uint32_t NTIM_COMPRESSION_NONE = 0;
+		static constexpr uint32_t NTIM_COMPRESSION_LZ4 = 1;
+
+		// Cache entry file layout, little-endian:
+		// AssetCacheHeader
+		// payloadSize bytes holding the asset in its loaded binary form
+		// An entry is valid for a source file with the same size and either the same modification time or the same content hash
+		struct AssetCacheHeader {
+			char magic[4];
+			uint32_t version;
+			uint64_t keyHash;
+			uint64_t sourceSize;
+			int64_t sourceModificationTime;
+			uint64_t sourceHash;
+			uint64_t payloadSize;
+		};
+
+		static constexpr char NTAC_MAGIC[4] = { 'N', 'T', 'A', 'C' };
+		static constexpr uint32_t NTAC_VERSION = 4;
+
+		static constexpr uint32_t NO_CACHED_IMAGE = std::numeric_limits<uint32_t>::max();
+
+		// Large enough for a job to outweigh its dispatch
+		static constexpr size_t BOUNDS_VERTICES_PER_JOB = 16384;
+
+		// Simplification stops before moving the surface by more than 5% of the mesh's size
+		static constexpr float LOD_MAX_ERROR = 0.05f;
+
+		static size_t getNtmbDataSize(uint32_t vertexCount, uint32_t indexCount, uint32_t attributeMask) {
+			size_t vertexSize = 3 * sizeof(float);
+			for (const MeshNtmbAttribute& attribute : NTMB_ATTRIBUTES) {
+				if (attributeMask & attribute.bit) {
+					vertexSize += attribute.size;
+				}
+			}
+
+			return (static_cast<size_t>(vertexCount) * vertexSize) + (static_cast<size_t>(indexCount) * sizeof(uint32_t));
+		}
+
+		static uint64_t hashData(const uint8_t* data, size_t size) {
+			uint64_t hash = 0xCBF29CE484222325ull ^ (static_cast<uint64_t>(size) * 0x9E3779B97F4A7C15ull);
+			size_t i = 0;
+			for (; (i + sizeof(uint64_t)) <= size; i += sizeof(uint64_t)) {
+				uint64_t word;
+				std::memcpy(&word, data + i, sizeof(uint64_t));
+				hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+				hash ^= hash >> 29;
+			}
+			uint64_t tail = 0;
+			if (i < size) {
+				std::memcpy(&tail, data + i, size - i);
+			}
+			hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+			hash ^= hash >> 32;
+
+			return hash;
+		}
+
+		std::string getCacheKey(const std::string& assetType, const std::string& filePath) {
+			if (m_cacheDirectory.empty()) {
+				return "";
+			}
+
+			std::error_code error;
+			const std::filesystem::path absolutePath = std::filesystem::absolute(filePath, error);
+
+			return assetType + ":" + (error ? filePath : absolutePath.lexically_normal().string());
+		}
+
+		std::string getCacheEntryPath(const std::string& cacheKey) {
+			const uint64_t keyHash = hashData(reinterpret_cast<const uint8_t*>(cacheKey.data()), cacheKey.size());
+			char entryName[17];
+			std::snprintf(entryName, sizeof(entryName), "%016llx", static_cast<unsigned long long>(keyHash));
+
+			return m_cacheDirectory + "/" + entryName + ".ntac";
+		}
+
+		static int64_t getFileModificationTime(const std::string& filePath, std::error_code& error) {
+			return static_cast<int64_t>(std::filesystem::last_write_time(filePath, error).time_since_epoch().count());
+		}
+
+		// Returns the mapped cache entry of filePath, nullptr if there is none or if filePath changed since it was written
+		std::shared_ptr<MappedFile> openCacheEntry(const std::string& cacheKey, const std::string& filePath) {
+			if (m_cacheDirectory.empty()) {
+				return nullptr;
+			}
+
+			const std::string entryPath = getCacheEntryPath(cacheKey);
+			std::shared_ptr<MappedFile> entry = std::make_shared<MappedFile>();
+			if (!entry->open(entryPath) || (entry->getSize() < sizeof(AssetCacheHeader))) {
+				return nullptr;
+			}
+
+			AssetCacheHeader header;
+			std::memcpy(&header, entry->getData(), sizeof(AssetCacheHeader));
+			if ((std::memcmp(header.magic, NTAC_MAGIC, sizeof(header.magic)) != 0) || (header.version != NTAC_VERSION) || (header.keyHash != hashData(reinterpret_cast<const uint8_t*>(cacheKey.data()), cacheKey.size())) || (header.payloadSize != (entry->getSize() - sizeof(AssetCacheHeader)))) {
+				return nullptr;
+			}
+
+			std::error_code error;
+			const uint64_t sourceSize = static_cast<uint64_t>(std::filesystem::file_size(filePath, error));
+			if (error || (header.sourceSize != sourceSize)) {
+				return nullptr;
+			}
+			const int64_t sourceModificationTime = getFileModificationTime(filePath, error);
+			if (error) {
+				return nullptr;
+			}
+
+			// A touched but unchanged source, after a checkout for example, keeps its entry, which is updated to skip hashing next time
+			if (header.sourceModificationTime != sourceModificationTime) {
+				MappedFile source;
+				if (!source.open(filePath) || (hashData(source.getData(), source.getSize()) != header.sourceHash)) {
+					return nullptr;
+				}
+
+				std::fstream entryFile(entryPath, std::ios::in | std::ios::out | std::ios::binary);
+				entryFile.seekp(static_cast<std::streamoff>(offsetof(AssetCacheHeader, sourceModificationTime)));
+				entryFile.write(reinterpret_cast<const char*>(&sourceModificationTime), sizeof(int64_t));
+			}
+
+			return entry;
+		}
+
+		// Entries are written to a temporary file then renamed so that concurrent loads never see a partial entry
+		void writeCacheEntry(const std::string& cacheKey, const std::string& filePath, const std::vector<uint8_t>& payload) {
+			AssetCacheHeader header;
+			std::memcpy(header.magic, NTAC_MAGIC, sizeof(header.magic));
+			header.version = NTAC_VERSION;
+			header.keyHash = hashData(reinterpret_cast<const uint8_t*>(cacheKey.data()), cacheKey.size());
+			header.payloadSize = payload.size();
+
+			// The modification time is read before the content so that a source modified in between gets rehashed
+			std::error_code error;
+			header.sourceModificationTime = getFileModificationTime(filePath, error);
+			MappedFile source;
+			if (error || !source.open(filePath)) {
+				return;
+			}
+			header.sourceSize = source.getSize();
+			header.sourceHash = hashData(source.getData(), source.getSize());
+
+			const std::string entryPath = getCacheEntryPath(cacheKey);
+			const std::string temporaryEntryPath = entryPath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+			{
+				std::ofstream entryFile(temporaryEntryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+				if (!entryFile.is_open()) {
+					NTSHENGN_ASSET_MANAGER_WARNING("Could not write cache entry \"" + entryPath + "\".");
+
+					return;
+				}
+				entryFile.write(reinterpret_cast<const char*>(&header), sizeof(AssetCacheHeader));
+				entryFile.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+				if (!entryFile.good()) {
+					entryFile.close();
+					std::filesystem::remove(temporaryEntryPath, error);
+					NTSHENGN_ASSET_MANAGER_WARNING("Could not write cache entry \"" + entryPath + "\".");
+
+					return;
+				}
+			}
+			std::filesystem::rename(temporaryEntryPath, entryPath, error);
+			if (error) {
+				std::filesystem::remove(temporaryEntryPath, error);
+			}
+		}
+
+		// Loads resource from the cache entry of filePath, returns false if there is no valid entry
+		template <typename T>
+		bool loadFromCache(const std::string& cacheKey, const std::string& filePath, T& resource) {
+			std::shared_ptr<MappedFile> entry = openCacheEntry(cacheKey, filePath);
+			if (!entry) {
+				return false;
+			}
+
+			const std::string entryPath = getCacheEntryPath(cacheKey);
+			if (!deserializeCachePayload(entry, entryPath, entry->getData() + sizeof(AssetCacheHeader), entry->getData() + entry->getSize(), resource)) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Cache entry \"" + entryPath + "\" for \"" + filePath + "\" is corrupted, loading the file instead.");
+				resource = T();
+
+				return false;
+			}
+
+			return true;
+		}
+
+		template <typename T>
+		void writeToCache(const std::string& cacheKey, const std::string& filePath, const T& resource) {
+			if (m_cacheDirectory.empty()) {
+				return;
+			}
+
+			std::vector<uint8_t> payload;
+			if (serializeCachePayload(resource, payload)) {
+				writeCacheEntry(cacheKey, filePath, payload);
+			}
+		}
+
+		template <typename T>
+		static void writeCacheValue(std::vector<uint8_t>& payload, const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>, "Cached values must be trivially copyable.");
+
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+			payload.insert(payload.end(), bytes, bytes + sizeof(T));
+		}
+
+		template <typename T>
+		static void writeCacheArray(std::vector<uint8_t>& payload, const std::vector<T>& values) {
+			static_assert(std::is_trivially_copyable_v<T>, "Cached values must be trivially copyable.");
+
+			writeCacheValue(payload, static_cast<uint64_t>(values.size()));
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+			payload.insert(payload.end(), bytes, bytes + (values.size() * sizeof(T)));
+		}
+
+		template <typename T>
+		static bool readCacheValue(const uint8_t*& data, const uint8_t* end, T& value) {
+			if (static_cast<size_t>(end - data) < sizeof(T)) {
+				return false;
+			}
+
+			std::memcpy(&value, data, sizeof(T));
+			data += sizeof(T);
+
+			return true;
+		}
+
+		template <typename T>
+		static bool readCacheArray(const uint8_t*& data, const uint8_t* end, std::vector<T>& values) {
+			uint64_t count;
+			if (!readCacheValue(data, end, count) || (count > (static_cast<size_t>(end - data) / sizeof(T)))) {
+				return false;
+			}
+
+			values.resize(static_cast<size_t>(count));
+			if (count != 0) {
+				std::memcpy(values.data(), data, static_cast<size_t>(count) * sizeof(T));
+			}
+			data += static_cast<size_t>(count) * sizeof(T);
+
+			return true;
+		}
+
+		static void writeCacheMeshlets(std::vector<uint8_t>& payload, const Mesh& mesh) {
+			writeCacheArray(payload, mesh.meshlets);
+			writeCacheArray(payload, mesh.meshletVertices);
+			writeCacheArray(payload, mesh.meshletTriangles);
+		}
+
+		// Meshlets must stay within the mesh's vertices and their own ranges
+		static bool readCacheMeshlets(const uint8_t*& data, const uint8_t* end, Mesh& mesh) {
+			if (!readCacheArray(data, end, mesh.meshlets) || !readCacheArray(data, end, mesh.meshletVertices) || !readCacheArray(data, end, mesh.meshletTriangles)) {
+				return false;
+			}
+
+			for (const Meshlet& meshlet : mesh.meshlets) {
+				if (((static_cast<uint64_t>(meshlet.vertexOffset) + meshlet.vertexCount) > mesh.meshletVertices.size()) || ((static_cast<uint64_t>(meshlet.triangleOffset) + (static_cast<uint64_t>(meshlet.triangleCount) * 3)) > mesh.meshletTriangles.size())) {
+					return false;
+				}
+				for (uint32_t i = 0; i < (meshlet.triangleCount * 3); i++) {
+					if (mesh.meshletTriangles[meshlet.triangleOffset + i] >= meshlet.vertexCount) {
+						return false;
+					}
+				}
+			}
+			for (uint32_t vertex : mesh.meshletVertices) {
+				if (vertex >= mesh.vertices.size()) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool serializeCachePayload(const Sound& sound, std::vector<uint8_t>& payload) {
+			writeCacheValue(payload, sound.channels);
+			writeCacheValue(payload, sound.sampleRate);
+			writeCacheValue(payload, sound.bitsPerSample);
+			writeCacheValue(payload, static_cast<uint64_t>(sound.size));
+			writeCacheArray(payload, sound.data);
+
+			return true;
+		}
+
+		bool deserializeCachePayload(const std::shared_ptr<MappedFile>& entry, const std::string& entryPath, const uint8_t* data, const uint8_t* end, Sound& sound) {
+			NTSHENGN_UNUSED(entry);
+			NTSHENGN_UNUSED(entryPath);
+
+			uint64_t size;
+			if (!readCacheValue(data, end, sound.channels) || !readCacheValue(data, end, sound.sampleRate) || !readCacheValue(data, end, sound.bitsPerSample) || !readCacheValue(data, end, size) || !readCacheArray(data, end, sound.data)) {
+				return false;
+			}
+			sound.size = static_cast<size_t>(size);
+
+			return (data == end) && (sound.size != 0);
+		}
+
+		// Meshes are stored in the .ntmb format, with their calculated tangents
+		// The meshlets are stored after the mesh
+		bool serializeCachePayload(const Mesh& mesh, std::vector<uint8_t>& payload) {
+			std::vector<uint8_t> meshData;
+			serializeMeshNtmb(mesh, true, meshData);
+			writeCacheArray(payload, meshData);
+			writeCacheMeshlets(payload, mesh);
+
+			return true;
+		}
+
+		bool deserializeCachePayload(const std::shared_ptr<MappedFile>& entry, const std::string& entryPath, const uint8_t* data, const uint8_t* end, Mesh& mesh) {
+			NTSHENGN_UNUSED(entry);
+
+			std::vector<uint8_t> meshData;
+			if (!readCacheArray(data, end, meshData)) {
+				return false;
+			}
+			deserializeMeshNtmb(meshData.data(), meshData.size(), entryPath, mesh);
+
+			return !mesh.vertices.empty() && readCacheMeshlets(data, end, mesh) && (data == end);
+		}
+
+		// Images are stored uncompressed in the binary .ntim format so that they can stay mapped
+		bool serializeCachePayload(const Image& image, std::vector<uint8_t>& payload) {
+			return serializeImageNtim(image, false, payload);
+		}
+
+		bool deserializeCachePayload(const std::shared_ptr<MappedFile>& entry, const std::string& entryPath, const uint8_t* data, const uint8_t* end, Image& image) {
+			deserializeImageNtim(data, static_cast<size_t>(end - data), entry, entryPath, image);
+
+			return image.width != 0;
+		}
+
+		// The font image is stored after the glyphs
+		bool serializeCachePayload(const Font& font, std::vector<uint8_t>& payload) {
+			writeCacheValue(payload, font.imageSamplerFilter);
+			writeCacheValue(payload, static_cast<uint64_t>(font.glyphs.size()));
+			for (const std::pair<const char, FontGlyph>& glyph : font.glyphs) {
+				writeCacheValue(payload, glyph.first);
+				writeCacheValue(payload, glyph.second);
+			}
+
+			return serializeImageNtim(*font.image, false, payload);
+		}
+
+		bool deserializeCachePayload(const std::shared_ptr<MappedFile>& entry, const std::string& entryPath, const uint8_t* data, const uint8_t* end, Font& font) {
+			uint64_t glyphCount;
+			if (!readCacheValue(data, end, font.imageSamplerFilter) || !readCacheValue(data, end, glyphCount)) {
+				return false;
+			}
+			for (uint64_t i = 0; i < glyphCount; i++) {
+				char character;
+				FontGlyph glyph;
+				if (!readCacheValue(data, end, character) || !readCacheValue(data, end, glyph)) {
+					return false;
+				}
+				font.glyphs[character] = glyph;
+			}
+
+			Image image;
+			deserializeImageNtim(data, static_cast<size_t>(end - data), entry, entryPath, image);
+			if (image.width == 0) {
+				return false;
+			}
+			font.image = createImage();
+			*font.image = std::move(image);
+
+			return true;
+		}
+
+		// The images used by the materials are stored once each, before the primitives which refer to them by index
+		// Images loaded from a file are stored as their path and loaded again, only the images created for the model are stored whole
+		bool serializeCachePayload(const Model& model, std::vector<uint8_t>& payload) {
+			std::vector<Image*> images;
+			std::unordered_map<const Image*, uint32_t> imageIndices;
+			for (const ModelPrimitive& primitive : model.primitives) {
+				for (const Texture* texture : getMaterialTextures(primitive.material)) {
+					if (texture->image && (imageIndices.find(texture->image) == imageIndices.end())) {
+						imageIndices[texture->image] = static_cast<uint32_t>(images.size());
+						images.push_back(texture->image);
+					}
+				}
+			}
+
+			std::vector<std::string> imagePaths(images.size());
+			{
+				std::unique_lock<std::mutex> lock(getCache<Image>().mutex);
+
+				for (size_t i = 0; i < images.size(); i++) {
+					if (m_imagePaths.exist(images[i])) {
+						imagePaths[i] = m_imagePaths[images[i]];
+					}
+				}
+			}
+
+			writeCacheValue(payload, static_cast<uint64_t>(images.size()));
+			for (size_t i = 0; i < images.size(); i++) {
+				writeCacheArray(payload, std::vector<char>(imagePaths[i].begin(), imagePaths[i].end()));
+				if (!imagePaths[i].empty()) {
+					continue;
+				}
+
+				std::vector<uint8_t> imageData;
+				if (!serializeImageNtim(*images[i], true, imageData)) {
+					return false;
+				}
+				writeCacheArray(payload, imageData);
+			}
+
+			writeCacheValue(payload, static_cast<uint64_t>(model.primitives.size()));
+			for (const ModelPrimitive& primitive : model.primitives) {
+				std::vector<uint8_t> meshData;
+				serializeMeshNtmb(primitive.mesh, true, meshData);
+				writeCacheArray(payload, meshData);
+				writeCacheMeshlets(payload, primitive.mesh);
+
+				writeCacheValue(payload, static_cast<uint64_t>(primitive.mesh.skin.joints.size()));
+				for (const Joint& joint : primitive.mesh.skin.joints) {
+					writeCacheValue(payload, joint.inverseBindMatrix);
+					writeCacheValue(payload, joint.localTransform);
+					writeCacheArray(payload, joint.children);
+				}
+				writeCacheValue(payload, primitive.mesh.skin.rootJoint);
+				writeCacheValue(payload, primitive.mesh.skin.baseMatrix);
+				writeCacheValue(payload, primitive.mesh.skin.inverseGlobalTransform);
+
+				for (const Texture* texture : getMaterialTextures(primitive.material)) {
+					writeCacheValue(payload, texture->image ? imageIndices[texture->image] : NO_CACHED_IMAGE);
+					writeCacheValue(payload, texture->imageSampler);
+				}
+				writeCacheValue(payload, primitive.material.emissiveFactor);
+				writeCacheValue(payload, primitive.material.alphaCutoff);
+				writeCacheValue(payload, primitive.material.indexOfRefraction);
+
+				writeCacheValue(payload, static_cast<uint64_t>(primitive.lods.size()));
+				for (const ModelPrimitiveLOD& lod : primitive.lods) {
+					writeCacheArray(payload, lod.indices);
+					writeCacheValue(payload, lod.screenSize);
+				}
+			}
+
+			writeCacheValue(payload, static_cast<uint64_t>(model.animations.size()));
+			for (const Animation& animation : model.animations) {
+				writeCacheValue(payload, animation.duration);
+				writeCacheValue(payload, static_cast<uint64_t>(animation.jointChannels.size()));
+				for (const std::pair<const uint32_t, std::vector<AnimationChannel>>& jointChannels : animation.jointChannels) {
+					writeCacheValue(payload, jointChannels.first);
+					writeCacheValue(payload, static_cast<uint64_t>(jointChannels.second.size()));
+					for (const AnimationChannel& channel : jointChannels.second) {
+						writeCacheValue(payload, channel.interpolationType);
+						writeCacheValue(payload, channel.transformType);
+						writeCacheArray(payload, channel.keyframes);
+					}
+				}
+			}
+
+			return true;
+		}
+
+		// The images are only loaded or created once the whole entry has been read
+		bool deserializeCachePayload(const std::shared_ptr<MappedFile>& entry, const std::string& entryPath, const uint8_t* data, const uint8_t* end, Model& model) {
+			NTSHENGN_UNUSED(entry);
+
+			uint64_t imageCount;
+			if (!readCacheValue(data, end, imageCount) || (imageCount > static_cast<size_t>(end - data))) {
+				return false;
+			}
+			std::vector<Image> images(static_cast<size_t>(imageCount));
+			std::vector<std::string> imagePaths(images.size());
+			for (size_t i = 0; i < images.size(); i++) {
+				std::vector<char> imagePath;
+				if (!readCacheArray(data, end, imagePath)) {
+					return false;
+				}
+				if (!imagePath.empty()) {
+					imagePaths[i].assign(imagePath.begin(), imagePath.end());
+					continue;
+				}
+
+				std::vector<uint8_t> imageData;
+				if (!readCacheArray(data, end, imageData)) {
+					return false;
+				}
+				deserializeImageNtim(imageData.data(), imageData.size(), nullptr, entryPath, images[i]);
+				if (images[i].width == 0) {
+					return false;
+				}
+			}
+
+			std::vector<std::array<uint32_t, 6>> primitiveImageIndices;
+			uint64_t primitiveCount;
+			if (!readCacheValue(data, end, primitiveCount) || (primitiveCount > static_cast<size_t>(end - data))) {
+				return false;
+			}
+			model.primitives.resize(static_cast<size_t>(primitiveCount));
+			primitiveImageIndices.resize(model.primitives.size());
+			for (size_t i = 0; i < model.primitives.size(); i++) {
+				ModelPrimitive& primitive = model.primitives[i];
+
+				std::vector<uint8_t> meshData;
+				if (!readCacheArray(data, end, meshData)) {
+					return false;
+				}
+				deserializeMeshNtmb(meshData.data(), meshData.size(), entryPath, primitive.mesh);
+				if (primitive.mesh.vertices.empty() || !readCacheMeshlets(data, end, primitive.mesh)) {
+					return false;
+				}
+
+				uint64_t jointCount;
+				if (!readCacheValue(data, end, jointCount) || (jointCount > static_cast<size_t>(end - data))) {
+					return false;
+				}
+				primitive.mesh.skin.joints.resize(static_cast<size_t>(jointCount));
+				for (Joint& joint : primitive.mesh.skin.joints) {
+					if (!readCacheValue(data, end, joint.inverseBindMatrix) || !readCacheValue(data, end, joint.localTransform) || !readCacheArray(data, end, joint.children)) {
+						return false;
+					}
+				}
+				if (!readCacheValue(data, end, primitive.mesh.skin.rootJoint) || !readCacheValue(data, end, primitive.mesh.skin.baseMatrix) || !readCacheValue(data, end, primitive.mesh.skin.inverseGlobalTransform)) {
+					return false;
+				}
+
+				const std::array<Texture*, 6> textures = getMaterialTextures(primitive.material);
+				for (size_t j = 0; j < textures.size(); j++) {
+					if (!readCacheValue(data, end, primitiveImageIndices[i][j]) || !readCacheValue(data, end, textures[j]->imageSampler) || ((primitiveImageIndices[i][j] != NO_CACHED_IMAGE) && (primitiveImageIndices[i][j] >= images.size()))) {
+						return false;
+					}
+				}
+				if (!readCacheValue(data, end, primitive.material.emissiveFactor) || !readCacheValue(data, end, primitive.material.alphaCutoff) || !readCacheValue(data, end, primitive.material.indexOfRefraction)) {
+					return false;
+				}
+
+				uint64_t lodCount;
+				if (!readCacheValue(data, end, lodCount) || (lodCount > static_cast<size_t>(end - data))) {
+					return false;
+				}
+				primitive.lods.resize(static_cast<size_t>(lodCount));
+				for (ModelPrimitiveLOD& lod : primitive.lods) {
+					if (!readCacheArray(data, end, lod.indices) || !readCacheValue(data, end, lod.screenSize)) {
+						return false;
+					}
+					for (uint32_t index : lod.indices) {
+						if (index >= primitive.mesh.vertices.size()) {
+							return false;
+						}
+					}
+				}
+			}
+
+			uint64_t animationCount;
+			if (!readCacheValue(data, end, animationCount) || (animationCount > static_cast<size_t>(end - data))) {
+				return false;
+			}
+			model.animations.resize(static_cast<size_t>(animationCount));
+			for (Animation& animation : model.animations) {
+				uint64_t jointCount;
+				if (!readCacheValue(data, end, animation.duration) || !readCacheValue(data, end, jointCount)) {
+					return false;
+				}
+				for (uint64_t i = 0; i < jointCount; i++) {
+					uint32_t joint;
+					uint64_t channelCount;
+					if (!readCacheValue(data, end, joint) || !readCacheValue(data, end, channelCount) || (channelCount > static_cast<size_t>(end - data))) {
+						return false;
+					}
+					std::vector<AnimationChannel>& channels = animation.jointChannels[joint];
+					channels.resize(static_cast<size_t>(channelCount));
+					for (AnimationChannel& channel : channels) {
+						if (!readCacheValue(data, end, channel.interpolationType) || !readCacheValue(data, end, channel.transformType) || !readCacheArray(data, end, channel.keyframes)) {
+							return false;
+						}
+					}
+				}
+			}
+			if (data != end) {
+				return false;
+			}
+
+			// Each texture using a loaded image takes a reference to it, as when the model's loader loads it
+			std::vector<Image*> modelImages(images.size(), nullptr);
+			std::vector<uint32_t> imageReferenceCounts(images.size(), 0);
+			for (size_t i = 0; i < model.primitives.size(); i++) {
+				for (uint32_t imageIndex : primitiveImageIndices[i]) {
+					if (imageIndex != NO_CACHED_IMAGE) {
+						imageReferenceCounts[imageIndex]++;
+					}
+				}
+			}
+			for (size_t i = 0; i < images.size(); i++) {
+				if (imagePaths[i].empty() || (imageReferenceCounts[i] == 0)) {
+					continue;
+				}
+
+				modelImages[i] = loadImage(imagePaths[i]);
+				if (!modelImages[i]) {
+					for (size_t j = 0; j < i; j++) {
+						if (!modelImages[j]) {
+							continue;
+						}
+
+						for (uint32_t k = 0; k < imageReferenceCounts[j]; k++) {
+							release(modelImages[j]);
+						}
+					}
+
+					return false;
+				}
+				for (uint32_t j = 1; j < imageReferenceCounts[i]; j++) {
+					retain(modelImages[i]);
+				}
+			}
+			for (size_t i = 0; i < images.size(); i++) {
+				if (imagePaths[i].empty()) {
+					modelImages[i] = createImage();
+					*modelImages[i] = std::move(images[i]);
+				}
+			}
+			for (size_t i = 0; i < model.primitives.size(); i++) {
+				const std::array<Texture*, 6> textures = getMaterialTextures(model.primitives[i].material);
+				for (size_t j = 0; j < textures.size(); j++) {
+					textures[j]->image = (primitiveImageIndices[i][j] != NO_CACHED_IMAGE) ? modelImages[primitiveImageIndices[i][j]] : nullptr;
+				}
+			}
+
+			return true;
+		}
+
+		static std::array<Texture*, 6> getMaterialTextures(Material& material) {
+			return { &material.diffuseTexture, &material.normalTexture, &material.metalnessTexture, &material.roughnessTexture, &material.occlusionTexture, &material.emissiveTexture };
+		}
+
+		static std::array<const Texture*, 6> getMaterialTextures(const Material& material) {
+			return { &material.diffuseTexture, &material.normalTexture, &material.metalnessTexture, &material.roughnessTexture, &material.occlusionTexture, &material.emissiveTexture };
+		}
+
+		// Reduces chunks of the mesh's vertices in parallel when a job system is set and the mesh is large, all vertices at once otherwise
+		template <typename T>
+		T reduceVertices(const Mesh& mesh, const T& identity, const std::function<T(const Vertex*, size_t)>& map, const std::function<T(const T&, const T&)>& operation) {
+			if (!m_jobSystem || (mesh.vertices.size() < (BOUNDS_VERTICES_PER_JOB * 2))) {
+				return map(mesh.vertices.data(), mesh.vertices.size());
+			}
+
+			const uint32_t jobCount = static_cast<uint32_t>((mesh.vertices.size() + BOUNDS_VERTICES_PER_JOB - 1) / BOUNDS_VERTICES_PER_JOB);
+			return m_jobSystem->parallelReduce<T>(jobCount, 1, identity, [&mesh, &map](uint32_t jobIndex) {
+				const size_t firstVertex = static_cast<size_t>(jobIndex) * BOUNDS_VERTICES_PER_JOB;
+
+				return map(mesh.vertices.data() + firstVertex, std::min(BOUNDS_VERTICES_PER_JOB, mesh.vertices.size() - firstVertex));
+			}, operation);
+		}
+
+		// Positions are loaded four floats at a time with the normal's first component, which is ignored
+		// NaN positions are ignored as the minimum and maximum instructions return their second operand, the accumulator, when a lane is NaN
+		static std::array<Math::vec3, 2> calculatePositionAABB(const Vertex* vertices, size_t vertexCount) {
+			static_assert(offsetof(Vertex, normal) == (offsetof(Vertex, position) + sizeof(Math::vec3)), "Vertex positions must be followed by another float.");
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+			__m128 min0 = _mm_set1_ps(std::numeric_limits<float>::max());
+			__m128 max0 = _mm_set1_ps(std::numeric_limits<float>::lowest());
+			__m128 min1 = min0;
+			__m128 max1 = max0;
+			size_t i = 0;
+			for (; (i + 1) < vertexCount; i += 2) {
+				const __m128 position0 = _mm_loadu_ps(&vertices[i].position.x);
+				const __m128 position1 = _mm_loadu_ps(&vertices[i + 1].position.x);
+				min0 = _mm_min_ps(position0, min0);
+				max0 = _mm_max_ps(position0, max0);
+				min1 = _mm_min_ps(position1, min1);
+				max1 = _mm_max_ps(position1, max1);
+			}
+			if (i < vertexCount) {
+				const __m128 position = _mm_loadu_ps(&vertices[i].position.x);
+				min0 = _mm_min_ps(position, min0);
+				max0 = _mm_max_ps(position, max0);
+			}
+
+			float min[4];
+			float max[4];
+			_mm_storeu_ps(min, _mm_min_ps(min0, min1));
+			_mm_storeu_ps(max, _mm_max_ps(max0, max1));
+#elif defined(__aarch64__) || defined(_M_ARM64)
+			float32x4_t min0 = vdupq_n_f32(std::numeric_limits<float>::max());
+			float32x4_t max0 = vdupq_n_f32(std::numeric_limits<float>::lowest());
+			float32x4_t min1 = min0;
+			float32x4_t max1 = max0;
+			size_t i = 0;
+			for (; (i + 1) < vertexCount; i += 2) {
+				const float32x4_t position0 = vld1q_f32(&vertices[i].position.x);
+				const float32x4_t position1 = vld1q_f32(&vertices[i + 1].position.x);
+				min0 = vminnmq_f32(position0, min0);
+				max0 = vmaxnmq_f32(position0, max0);
+				min1 = vminnmq_f32(position1, min1);
+				max1 = vmaxnmq_f32(position1, max1);
+			}
+			if (i < vertexCount) {
+				const float32x4_t position = vld1q_f32(&vertices[i].position.x);
+				min0 = vminnmq_f32(position, min0);
+				max0 = vmaxnmq_f32(position, max0);
+			}
+
+			float min[4];
+			float max[4];
+			vst1q_f32(min, vminnmq_f32(min0, min1));
+			vst1q_f32(max, vmaxnmq_f32(max0, max1));
+#else
+			float min[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+			float max[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+			for (size_t i = 0; i < vertexCount; i++) {
+				for (size_t j = 0; j < 3; j++) {
+					min[j] = (vertices[i].position[j] < min[j]) ? vertices[i].position[j] : min[j];
+					max[j] = (vertices[i].position[j] > max[j]) ? vertices[i].position[j] : max[j];
+				}
+			}
+#endif
+
+			return { Math::vec3(min[0], min[1], min[2]), Math::vec3(max[0], max[1], max[2]) };
+		}
+
+		// Smallest and largest x, then y, then z
+		static std::array<Math::vec3, 6> mergeExtremePositions(const std::array<Math::vec3, 6>& a, const std::array<Math::vec3, 6>& b) {
+			std::array<Math::vec3, 6> extremes;
+			for (size_t i = 0; i < 3; i++) {
+				extremes[i * 2] = (b[i * 2][i] < a[i * 2][i]) ? b[i * 2] : a[i * 2];
+				extremes[(i * 2) + 1] = (b[(i * 2) + 1][i] > a[(i * 2) + 1][i]) ? b[(i * 2) + 1] : a[(i * 2) + 1];
+			}
+
+			return extremes;
+		}
+
+		// Smallest sphere enclosing both spheres, a negative radius is an empty sphere
+		static std::pair<Math::vec3, float> mergeBoundingSpheres(const std::pair<Math::vec3, float>& a, const std::pair<Math::vec3, float>& b) {
+			if (a.second < 0.0f) {
+				return b;
+			}
+			if (b.second < 0.0f) {
+				return a;
 			}
-		}
 
-		Image* createImage() {
-			Image newImage;
+			const Math::vec3 offset = b.first - a.first;
+			const float distance = offset.length();
+			if ((distance + b.second) <= a.second) {
+				return a;
+			}
+			if ((distance + a.second) <= b.second) {
+				return b;
+			}
 
-			m_imageResources.push_front(newImage);
+			const float radius = (distance + a.second + b.second) / 2.0f;
 
-			return &m_imageResources.front();
+			return { a.first + (offset * ((radius - a.second) / distance)), radius };
 		}
 
-		Image* loadImage(const std::string& filePath) {
-			if (!std::filesystem::exists(filePath)) {
-				NTSHENGN_ASSET_MANAGER_WARNING("Could not load image file \"" + filePath + "\" (file does not exist).");
-
-				return nullptr;
+		void processLoadedMesh(Mesh& mesh) {
+			if (m_optimizeMeshes) {
+				MeshOptimizer::optimize(mesh);
 			}
-
-			if (m_imagePaths.exist(filePath)) {
-				return m_imagePaths[filePath];
+			if (m_buildMeshlets) {
+				MeshletBuilder::build(mesh);
 			}
+		}
 
-			Image newImage;
-			if (File::extension(filePath) == "ntim") {
-				loadImageNtim(filePath, newImage);
+		// Meshes and models are cached in their processed form
+		std::string getMeshCacheType(const std::string& type) const {
+			std::string cacheType = type;
+			if (m_optimizeMeshes) {
+				cacheType += "Optimized";
 			}
-			else {
-				if (m_assetLoaderModule) {
-					newImage = m_assetLoaderModule->loadImage(filePath);
-				}
+			if (m_buildMeshlets) {
+				cacheType += "Meshlets";
 			}
 
-			if (newImage.width != 0) {
-				m_imageResources.push_front(newImage);
-
-				m_imagePaths.insert_or_assign(filePath, &m_imageResources.front());
+			return cacheType;
+		}
 
-				return &m_imageResources.front();
+		void generateModelLODs(Model& model) {
+			if (m_lodCount == 0) {
+				return;
 			}
-			else {
-				NTSHENGN_ASSET_MANAGER_WARNING("Could not load image file \"" + filePath + "\".");
 
-				return nullptr;
+			for (ModelPrimitive& primitive : model.primitives) {
+				generateLODs(primitive, m_lodCount);
 			}
 		}
 
-		Font* createFont() {
-			Font newFont;
+		// Attributes as four floats, padded with 0 or with 1 for the last component of positions and colors
+		static std::array<float, 4> getVertexAttributeValues(const Vertex& vertex, VertexAttribute attribute) {
+			switch (attribute) {
+			case VertexAttribute::Position:
+				return { vertex.position.x, vertex.position.y, vertex.position.z, 1.0f };
 
-			m_fontResources.push_front(newFont);
+			case VertexAttribute::Normal:
+				return { vertex.normal.x, vertex.normal.y, vertex.normal.z, 0.0f };
 
-			return &m_fontResources.front();
-		}
+			case VertexAttribute::UV:
+				return { vertex.uv.x, vertex.uv.y, 0.0f, 0.0f };
 
-		Font* loadFont(const std::string& filePath, float fontHeight) {
-			if (!std::filesystem::exists(filePath)) {
-				NTSHENGN_ASSET_MANAGER_WARNING("Could not load font file \"" + filePath + "\" (file does not exist).");
+			case VertexAttribute::Color:
+				return { vertex.color.x, vertex.color.y, vertex.color.z, 1.0f };
 
-				return nullptr;
-			}
+			case VertexAttribute::Tangent:
+				return { vertex.tangent.x, vertex.tangent.y, vertex.tangent.z, vertex.tangent.w };
 
-			if (fontHeight <= 0.0f) {
-				NTSHENGN_ASSET_MANAGER_WARNING("Font height for font file \"" + filePath + "\" should be greater than 0.");
+			case VertexAttribute::Weights:
+				return { vertex.weights.x, vertex.weights.y, vertex.weights.z, vertex.weights.w };
 
-				return nullptr;
+			default:
+				return { 0.0f, 0.0f, 0.0f, 0.0f };
 			}
+		}
 
-			if (m_fontPaths.exist(filePath + "/" + std::to_string(fontHeight))) {
-				return m_fontPaths[filePath + "/" + std::to_string(fontHeight)];
-			}
+		static void setVertexAttributeValues(Vertex& vertex, VertexAttribute attribute, const std::array<float, 4>& values) {
+			switch (attribute) {
+			case VertexAttribute::Position:
+				vertex.position = Math::vec3(values[0], values[1], values[2]);
+				break;
 
-			Font newFont;
-			if (m_assetLoaderModule) {
-				newFont = m_assetLoaderModule->loadFont(filePath, fontHeight);
-			}
+			case VertexAttribute::Normal:
+				vertex.normal = Math::vec3(values[0], values[1], values[2]);
+				break;
 
-			if (newFont.image) {
-				m_fontResources.push_front(newFont);
+			case VertexAttribute::UV:
+				vertex.uv = Math::vec2(values[0], values[1]);
+				break;
 
-				m_fontPaths.insert_or_assign(filePath + "/" + std::to_string(fontHeight), &m_fontResources.front());
+			case VertexAttribute::Color:
+				vertex.color = Math::vec3(values[0], values[1], values[2]);
+				break;
 
-				return &m_fontResources.front();
-			}
-			else {
-				NTSHENGN_ASSET_MANAGER_WARNING("Could not load font file \"" + filePath + "\".");
+			case VertexAttribute::Tangent:
+				vertex.tangent = Math::vec4(values[0], values[1], values[2], values[3]);
+				break;
 
-				return nullptr;
-			}
-		}
+			case VertexAttribute::Weights:
+				vertex.weights = Math::vec4(values[0], values[1], values[2], values[3]);
+				break;
 
-		void destroySound(Sound* sound) {
-			if (m_soundPaths.exist(sound)) {
-				m_soundPaths.erase(sound);
+			default:
+				break;
 			}
+		}
 
-			std::forward_list<Sound>::iterator prev = m_soundResources.before_begin();
-			for (std::forward_list<Sound>::iterator it = m_soundResources.begin(); it != m_soundResources.end(); it++) {
-				if (sound == &(*it)) {
-					m_soundResources.erase_after(prev);
-					return;
+		static void encodeVertexAttribute(VertexAttributeFormat format, const std::array<float, 4>& values, uint8_t* destination) {
+			switch (format) {
+			case VertexAttributeFormat::Float32x2:
+			case VertexAttributeFormat::Float32x3:
+			case VertexAttributeFormat::Float32x4:
+				std::memcpy(destination, values.data(), getVertexAttributeFormatSize(format));
+				break;
+
+			case VertexAttributeFormat::Float16x2:
+			case VertexAttributeFormat::Float16x4:
+				for (size_t i = 0; i < (getVertexAttributeFormatSize(format) / sizeof(uint16_t)); i++) {
+					const uint16_t half = Quantization::floatToHalf(values[i]);
+					std::memcpy(destination + (i * sizeof(uint16_t)), &half, sizeof(uint16_t));
 				}
+				break;
 
-				prev = it;
+			case VertexAttributeFormat::Octahedral16x2: {
+				const std::array<int16_t, 2> encodedDirection = Quantization::encodeOctahedral16(Math::vec3(values[0], values[1], values[2]));
+				std::memcpy(destination, encodedDirection.data(), 2 * sizeof(int16_t));
+				break;
 			}
-			
-			NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy sound resource.", Result::AssetManagerError);
-		}
 
-		void destroyModel(Model* model) {
-			if (m_modelPaths.exist(model)) {
-				m_modelPaths.erase(model);
-			}
+			case VertexAttributeFormat::Snorm8x4:
+				for (size_t i = 0; i < 4; i++) {
+					const int8_t snorm = Quantization::floatToSnorm8(values[i]);
+					std::memcpy(destination + i, &snorm, sizeof(int8_t));
+				}
+				break;
 
-			std::forward_list<Model>::iterator prev = m_modelResources.before_begin();
-			for (std::forward_list<Model>::iterator it = m_modelResources.begin(); it != m_modelResources.end(); it++) {
-				if (model == &(*it)) {
-					m_modelResources.erase_after(prev);
-					return;
+			case VertexAttributeFormat::Snorm16x4:
+				for (size_t i = 0; i < 4; i++) {
+					const int16_t snorm = Quantization::floatToSnorm16(values[i]);
+					std::memcpy(destination + (i * sizeof(int16_t)), &snorm, sizeof(int16_t));
 				}
+				break;
 
-				prev = it;
-			}
+			case VertexAttributeFormat::Unorm8x4:
+				for (size_t i = 0; i < 4; i++) {
+					destination[i] = Quantization::floatToUnorm8(values[i]);
+				}
+				break;
 
-			NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy model resource.", Result::AssetManagerError);
-		}
+			case VertexAttributeFormat::Unorm16x4:
+				for (size_t i = 0; i < 4; i++) {
+					const uint16_t unorm = Quantization::floatToUnorm16(values[i]);
+					std::memcpy(destination + (i * sizeof(uint16_t)), &unorm, sizeof(uint16_t));
+				}
+				break;
 
-		void destroyImage(Image* image) {
-			if (m_imagePaths.exist(image)) {
-				m_imagePaths.erase(image);
+			default:
+				break;
 			}
+		}
 
-			std::forward_list<Image>::iterator prev = m_imageResources.before_begin();
-			for (std::forward_list<Image>::iterator it = m_imageResources.begin(); it != m_imageResources.end(); it++) {
-				if (image == &(*it)) {
-					m_imageResources.erase_after(prev);
-					return;
+		static std::array<float, 4> decodeVertexAttribute(VertexAttributeFormat format, const uint8_t* source) {
+			std::array<float, 4> values = { 0.0f, 0.0f, 0.0f, 0.0f };
+			switch (format) {
+			case VertexAttributeFormat::Float32x2:
+			case VertexAttributeFormat::Float32x3:
+			case VertexAttributeFormat::Float32x4:
+				std::memcpy(values.data(), source, getVertexAttributeFormatSize(format));
+				break;
+
+			case VertexAttributeFormat::Float16x2:
+			case VertexAttributeFormat::Float16x4:
+				for (size_t i = 0; i < (getVertexAttributeFormatSize(format) / sizeof(uint16_t)); i++) {
+					uint16_t half;
+					std::memcpy(&half, source + (i * sizeof(uint16_t)), sizeof(uint16_t));
+					values[i] = Quantization::halfToFloat(half);
 				}
+				break;
 
-				prev = it;
+			case VertexAttributeFormat::Octahedral16x2: {
+				std::array<int16_t, 2> encodedDirection;
+				std::memcpy(encodedDirection.data(), source, 2 * sizeof(int16_t));
+				const Math::vec3 direction = Quantization::decodeOctahedral16(encodedDirection);
+				values = { direction.x, direction.y, direction.z, 0.0f };
+				break;
 			}
 
-			NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy image resource.", Result::AssetManagerError);
-		}
+			case VertexAttributeFormat::Snorm8x4:
+				for (size_t i = 0; i < 4; i++) {
+					int8_t snorm;
+					std::memcpy(&snorm, source + i, sizeof(int8_t));
+					values[i] = Quantization::snorm8ToFloat(snorm);
+				}
+				break;
 
-		void destroyFont(Font* font) {
-			if (m_fontPaths.exist(font)) {
-				m_fontPaths.erase(font);
-			}
+			case VertexAttributeFormat::Snorm16x4:
+				for (size_t i = 0; i < 4; i++) {
+					int16_t snorm;
+					std::memcpy(&snorm, source + (i * sizeof(int16_t)), sizeof(int16_t));
+					values[i] = Quantization::snorm16ToFloat(snorm);
+				}
+				break;
 
-			std::forward_list<Font>::iterator prev = m_fontResources.before_begin();
-			for (std::forward_list<Font>::iterator it = m_fontResources.begin(); it != m_fontResources.end(); it++) {
-				if (font == &(*it)) {
-					m_fontResources.erase_after(prev);
-					return;
+			case VertexAttributeFormat::Unorm8x4:
+				for (size_t i = 0; i < 4; i++) {
+					values[i] = Quantization::unorm8ToFloat(source[i]);
+				}
+				break;
+
+			case VertexAttributeFormat::Unorm16x4:
+				for (size_t i = 0; i < 4; i++) {
+					uint16_t unorm;
+					std::memcpy(&unorm, source + (i * sizeof(uint16_t)), sizeof(uint16_t));
+					values[i] = Quantization::unorm16ToFloat(unorm);
 				}
+				break;
 
-				prev = it;
+			default:
+				break;
 			}
 
-			NTSHENGN_ASSET_MANAGER_ERROR("Could not destroy font resource.", Result::AssetManagerError);
+			return values;
 		}
 
-		void calculateTangents(Mesh& mesh) {
-			if (m_assetLoaderModule) {
-				m_assetLoaderModule->calculateTangents(mesh);
+		// The rounding error is moved to the largest weight so that the quantized weights sum to exactly 1
+		static void encodeVertexWeights(VertexAttributeFormat format, const std::array<float, 4>& weights, uint8_t* destination) {
+			const float weightSum = weights[0] + weights[1] + weights[2] + weights[3];
+			const int32_t maxValue = (format == VertexAttributeFormat::Unorm8x4) ? std::numeric_limits<uint8_t>::max() : std::numeric_limits<uint16_t>::max();
+			std::array<int32_t, 4> quantizedWeights;
+			int32_t quantizedSum = 0;
+			size_t largestWeight = 0;
+			for (size_t i = 0; i < 4; i++) {
+				const float weight = (weightSum > 0.0f) ? (weights[i] / weightSum) : weights[i];
+				quantizedWeights[i] = static_cast<int32_t>(std::lround(std::clamp(weight, 0.0f, 1.0f) * static_cast<float>(maxValue)));
+				quantizedSum += quantizedWeights[i];
+				if (weights[i] > weights[largestWeight]) {
+					largestWeight = i;
+				}
 			}
-			else {
-				NTSHENGN_ASSET_MANAGER_WARNING("Could not calculate tangent for mesh.");
+			if (weightSum > 0.0f) {
+				quantizedWeights[largestWeight] = std::clamp(quantizedWeights[largestWeight] + (maxValue - quantizedSum), 0, maxValue);
 			}
-		}
 
-		std::array<Math::vec3, 2> calculateAABB(const Mesh& mesh) {
-			Math::vec3 min = Math::vec3(std::numeric_limits<float>::max());
-			Math::vec3 max = Math::vec3(std::numeric_limits<float>::lowest());
-			for (const NtshEngn::Vertex& vertex : mesh.vertices) {
-				if (vertex.position[0] < min.x) {
-					min.x = vertex.position[0];
+			for (size_t i = 0; i < 4; i++) {
+				if (format == VertexAttributeFormat::Unorm8x4) {
+					destination[i] = static_cast<uint8_t>(quantizedWeights[i]);
 				}
-				if (vertex.position[0] > max.x) {
-					max.x = vertex.position[0];
+				else {
+					const uint16_t unorm = static_cast<uint16_t>(quantizedWeights[i]);
+					std::memcpy(destination + (i * sizeof(uint16_t)), &unorm, sizeof(uint16_t));
 				}
+			}
+		}
 
-				if (vertex.position[1] < min.y) {
-					min.y = vertex.position[1];
+		// Joints that do not fit in the format are clamped, getCompactVertexLayout picks a format they fit in
+		static void encodeVertexJoints(VertexAttributeFormat format, const std::array<uint32_t, 4>& joints, uint8_t* destination) {
+			for (size_t i = 0; i < 4; i++) {
+				if (format == VertexAttributeFormat::Uint8x4) {
+					destination[i] = static_cast<uint8_t>(std::min(joints[i], static_cast<uint32_t>(std::numeric_limits<uint8_t>::max())));
+				}
+				else if (format == VertexAttributeFormat::Uint16x4) {
+					const uint16_t joint = static_cast<uint16_t>(std::min(joints[i], static_cast<uint32_t>(std::numeric_limits<uint16_t>::max())));
+					std::memcpy(destination + (i * sizeof(uint16_t)), &joint, sizeof(uint16_t));
 				}
-				if (vertex.position[1] > max.y) {
-					max.y = vertex.position[1];
+				else {
+					std::memcpy(destination + (i * sizeof(uint32_t)), &joints[i], sizeof(uint32_t));
 				}
+			}
+		}
 
-				if (vertex.position[2] < min.z) {
-					min.z = vertex.position[2];
+		static std::array<uint32_t, 4> decodeVertexJoints(VertexAttributeFormat format, const uint8_t* source) {
+			std::array<uint32_t, 4> joints;
+			for (size_t i = 0; i < 4; i++) {
+				if (format == VertexAttributeFormat::Uint8x4) {
+					joints[i] = source[i];
 				}
-				if (vertex.position[2] > max.z) {
-					max.z = vertex.position[2];
+				else if (format == VertexAttributeFormat::Uint16x4) {
+					uint16_t joint;
+					std::memcpy(&joint, source + (i * sizeof(uint16_t)), sizeof(uint16_t));
+					joints[i] = joint;
+				}
+				else {
+					std::memcpy(&joints[i], source + (i * sizeof(uint32_t)), sizeof(uint32_t));
 				}
 			}
 
-			const float epsilon = 0.0001f;
+			return joints;
+		}
 
-			if (min.x == max.x) {
-				min.x -= epsilon;
-				max.x += epsilon;
-			}
+		static bool isImageNtimBinary(const std::string& filePath) {
+			std::ifstream file(filePath, std::ios::in | std::ios::binary);
+			char magic[sizeof(NTIM_MAGIC)];
 
-			if (min.y == max.y) {
-				min.y -= epsilon;
-				max.y += epsilon;
+			return file.read(magic, sizeof(magic)) && (std::memcmp(magic, NTIM_MAGIC, sizeof(NTIM_MAGIC)) == 0);
+		}
+
+		// Appends mesh in the binary .ntmb format to fileData
+		void serializeMeshNtmb(const Mesh& mesh, bool compress, std::vector<uint8_t>& fileData) {
+			MeshNtmbHeader header;
+			std::memcpy(header.magic, NTMB_MAGIC, sizeof(header.magic));
+			header.version = NTMB_VERSION;
+			header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+			header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+			header.topology = static_cast<uint32_t>(mesh.topology);
+			header.attributeMask = 0;
+			for (const Vertex& vertex : mesh.vertices) {
+				header.attributeMask |= ((vertex.normal.x != 0.0f) || (vertex.normal.y != 0.0f) || (vertex.normal.z != 0.0f)) ? NTMB_NORMAL : 0;
+				header.attributeMask |= ((vertex.uv.x != 0.0f) || (vertex.uv.y != 0.0f)) ? NTMB_UV : 0;
+				header.attributeMask |= ((vertex.color.x != 0.0f) || (vertex.color.y != 0.0f) || (vertex.color.z != 0.0f)) ? NTMB_COLOR : 0;
+				header.attributeMask |= ((vertex.tangent.x != 0.0f) || (vertex.tangent.y != 0.0f) || (vertex.tangent.z != 0.0f) || (vertex.tangent.w != 0.0f)) ? NTMB_TANGENT : 0;
+				header.attributeMask |= ((vertex.joints[0] != 0) || (vertex.joints[1] != 0) || (vertex.joints[2] != 0) || (vertex.joints[3] != 0)) ? NTMB_JOINTS : 0;
+				header.attributeMask |= ((vertex.weights.x != 0.0f) || (vertex.weights.y != 0.0f) || (vertex.weights.z != 0.0f) || (vertex.weights.w != 0.0f)) ? NTMB_WEIGHTS : 0;
+			}
+
+			std::vector<uint8_t> data(getNtmbDataSize(header.vertexCount, header.indexCount, header.attributeMask));
+			uint8_t* stream = data.data();
+			const auto writeStream = [&mesh, &stream](size_t offset, size_t size) {
+				for (const Vertex& vertex : mesh.vertices) {
+					std::memcpy(stream, reinterpret_cast<const uint8_t*>(&vertex) + offset, size);
+					stream += size;
+				}
+			};
+			writeStream(offsetof(Vertex, position), 3 * sizeof(float));
+			for (const MeshNtmbAttribute& attribute : NTMB_ATTRIBUTES) {
+				if (header.attributeMask & attribute.bit) {
+					writeStream(attribute.offset, attribute.size);
+				}
+			}
+			if (!mesh.indices.empty()) {
+				std::memcpy(stream, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
 			}
 
-			if (min.z == max.z) {
-				min.z -= epsilon;
-				max.z += epsilon;
+			header.uncompressedDataSize = data.size();
+			std::vector<uint8_t> compressedData;
+			if (compress) {
+				Compression::compressLZ4(data.data(), data.size(), compressedData);
 			}
+			// Keep the data uncompressed when compression does not help
+			header.compression = (compress && (compressedData.size() < data.size())) ? NTMB_COMPRESSION_LZ4 : NTMB_COMPRESSION_NONE;
+			const std::vector<uint8_t>& payload = (header.compression == NTMB_COMPRESSION_LZ4) ? compressedData : data;
+			header.dataSize = payload.size();
 
-			return { Math::vec3(min.x, min.y, min.z), Math::vec3(max.x, max.y, max.z) };
+			const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+			fileData.insert(fileData.end(), headerBytes, headerBytes + sizeof(MeshNtmbHeader));
+			fileData.insert(fileData.end(), payload.begin(), payload.end());
 		}
 
-	public:
-		void setAssetLoaderModule(AssetLoaderModuleInterface* assetLoaderModule) {
-			m_assetLoaderModule = assetLoaderModule;
+		// Appends image in the binary .ntim format to fileData, returns false if the image data does not match its size, format and mip level count
+		bool serializeImageNtim(const Image& image, bool compress, std::vector<uint8_t>& fileData) {
+			ImageNtimHeader header;
+			std::memcpy(header.magic, NTIM_MAGIC, sizeof(header.magic));
+			header.version = NTIM_VERSION;
+			header.width = image.width;
+			header.height = image.height;
+			header.format = static_cast<uint32_t>(image.format);
+			header.colorSpace = static_cast<uint32_t>(image.colorSpace);
+			header.mipLevelCount = image.mipLevelCount;
+			header.uncompressedDataSize = image.getDataSize();
+			if (header.uncompressedDataSize != getImageDataSize(image.format, image.width, image.height, image.mipLevelCount)) {
+				return false;
+			}
+
+			std::vector<uint8_t> compressedData;
+			if (compress) {
+				Compression::compressLZ4(image.getData(), image.getDataSize(), compressedData);
+			}
+			// Keep the data uncompressed when compression does not help
+			header.compression = (compress && (compressedData.size() < image.getDataSize())) ? NTIM_COMPRESSION_LZ4 : NTIM_COMPRESSION_NONE;
+			const uint8_t* payload = (header.compression == NTIM_COMPRESSION_LZ4) ? compressedData.data() : image.getData();
+			header.dataSize = (header.compression == NTIM_COMPRESSION_LZ4) ? compressedData.size() : image.getDataSize();
+
+			const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+			fileData.insert(fileData.end(), headerBytes, headerBytes + sizeof(ImageNtimHeader));
+			fileData.insert(fileData.end(), payload, payload + header.dataSize);
+
+			return true;
 		}
 
-	private:
-		void loadSoundNtsd(const std::string& filePath, Sound& sound) {
-			JSON json;
-			const JSON::Node& soundRoot = json.read(filePath);
-
-			if (soundRoot.contains("channels")) {
-				sound.channels = static_cast<uint8_t>(soundRoot["channels"].getNumber());
+		void loadMesh(const std::string& filePath, Mesh& mesh) {
+			if (File::extension(filePath) == "ntmb") {
+				loadMeshNtmb(filePath, mesh);
+				processLoadedMesh(mesh);
 			}
-
-			if (soundRoot.contains("sampleRate")) {
-				sound.sampleRate = static_cast<int32_t>(soundRoot["sampleRate"].getNumber());
+			else {
+				const std::string cacheKey = getCacheKey(getMeshCacheType("mesh"), filePath);
+				if (!loadFromCache(cacheKey, filePath, mesh)) {
+					loadMeshNtmh(filePath, mesh);
+					processLoadedMesh(mesh);
+					if (!mesh.vertices.empty()) {
+						writeToCache(cacheKey, filePath, mesh);
+					}
+				}
 			}
+		}
 
-			if (soundRoot.contains("bitsPerSample")) {
-				sound.bitsPerSample = static_cast<uint8_t>(soundRoot["bitsPerSample"].getNumber());
+		void loadSoundNtsd(const std::string& filePath, Sound& sound) {
+			JSON::Reader soundReader;
+			if (!soundReader.open(filePath) || (soundReader.next() != JSON::Reader::Event::ObjectStart)) {
+				return;
 			}
 
-			if (soundRoot.contains("size")) {
-				sound.size = static_cast<size_t>(soundRoot["size"].getNumber());
-			}
+			while (soundReader.next() == JSON::Reader::Event::Key) {
+				const std::string_view key = soundReader.getString();
 
-			if (soundRoot.contains("data")) {
-				for (size_t i = 0; i < soundRoot["data"].size(); i++) {
-					sound.data.push_back(static_cast<uint8_t>(soundRoot["data"][i].getNumber()));
+				if (key == "channels") {
+					sound.channels = static_cast<uint8_t>(soundReader.readInt());
+				}
+				else if (key == "sampleRate") {
+					sound.sampleRate = static_cast<int32_t>(soundReader.readInt());
+				}
+				else if (key == "bitsPerSample") {
+					sound.bitsPerSample = static_cast<uint8_t>(soundReader.readInt());
+				}
+				else if (key == "size") {
+					sound.size = static_cast<size_t>(soundReader.readInt());
+				}
+				else if (key == "data") {
+					soundReader.readNumberArray(sound.data);
+				}
+				else {
+					soundReader.skipValue();
 				}
 			}
 		}
@@ -396,72 +2907,192 @@ namespace NtshEngn {
 				{ "Unknown", MeshTopology::Unknown }
 			};
 
-			JSON json;
-			const JSON::Node& meshRoot = json.read(filePath);
+			// Mesh files can be large, stream them straight into the mesh instead of building a JSON tree
+			JSON::Reader meshReader;
+			if (!meshReader.open(filePath) || (meshReader.next() != JSON::Reader::Event::ObjectStart)) {
+				return;
+			}
 
 			bool hasNormals = false;
 			bool hasUvs = false;
 			bool hasIndices = false;
 			bool hasTangents = false;
+			std::string topology = "";
 
-			if (meshRoot.contains("vertices")) {
-				for (size_t i = 0; i < meshRoot["vertices"].size(); i++) {
-					const JSON::Node& vertexNode = meshRoot["vertices"][i];
+			while (meshReader.next() == JSON::Reader::Event::Key) {
+				const std::string_view key = meshReader.getString();
 
-					Vertex vertex;
-					if (vertexNode.contains("position")) {
-						vertex.position = { vertexNode["position"][0].getNumber(), vertexNode["position"][1].getNumber(), vertexNode["position"][2].getNumber() };
+				if (key == "vertices") {
+					JSON::Reader::Event verticesEvent = meshReader.next();
+					if (verticesEvent != JSON::Reader::Event::ArrayStart) {
+						meshReader.skipValue(verticesEvent);
+						continue;
 					}
 
-					if (vertexNode.contains("normal")) {
-						vertex.normal = { vertexNode["normal"][0].getNumber(), vertexNode["normal"][1].getNumber(), vertexNode["normal"][2].getNumber() };
-						hasNormals = true;
+					JSON::Reader::Event vertexEvent = meshReader.next();
+					while ((vertexEvent != JSON::Reader::Event::ArrayEnd) && (vertexEvent != JSON::Reader::Event::EndOfDocument)) {
+						if (vertexEvent != JSON::Reader::Event::ObjectStart) {
+							meshReader.skipValue(vertexEvent);
+							vertexEvent = meshReader.next();
+							continue;
+						}
+
+						Vertex vertex;
+						while (meshReader.next() == JSON::Reader::Event::Key) {
+							const std::string_view vertexKey = meshReader.getString();
+
+							if (vertexKey == "position") {
+								meshReader.readNumberArray(vertex.position.data(), 3);
+							}
+							else if (vertexKey == "normal") {
+								meshReader.readNumberArray(vertex.normal.data(), 3);
+								hasNormals = true;
+							}
+							else if (vertexKey == "uv") {
+								meshReader.readNumberArray(vertex.uv.data(), 2);
+								hasUvs = true;
+							}
+							else if (vertexKey == "color") {
+								meshReader.readNumberArray(vertex.color.data(), 3);
+							}
+							else if (vertexKey == "tangent") {
+								meshReader.readNumberArray(vertex.tangent.data(), 4);
+								hasTangents = true;
+							}
+							else if (vertexKey == "joints") {
+								meshReader.readNumberArray(vertex.joints.data(), 4);
+							}
+							else if (vertexKey == "weights") {
+								meshReader.readNumberArray(vertex.weights.data(), 4);
+							}
+							else {
+								meshReader.skipValue();
+							}
+						}
+
+						mesh.vertices.push_back(vertex);
+
+						vertexEvent = meshReader.next();
 					}
+				}
+				else if (key == "indices") {
+					meshReader.readNumberArray(mesh.indices);
+					hasIndices = true;
+				}
+				else if (key == "topology") {
+					topology = meshReader.readString();
+				}
+				else {
+					meshReader.skipValue();
+				}
+			}
 
-					if (vertexNode.contains("uv")) {
-						vertex.uv = { vertexNode["uv"][0].getNumber(), vertexNode["uv"][1].getNumber() };
-						hasUvs = true;
-					}
+			// Calculate tangents
+			if ((!hasTangents) && (hasNormals && hasUvs && hasIndices)) {
+				calculateTangents(mesh);
+			}
 
-					if (vertexNode.contains("color")) {
-						vertex.color = { vertexNode["color"][0].getNumber(), vertexNode["color"][1].getNumber(), vertexNode["color"][2].getNumber() };
-					}
+			if (!topology.empty()) {
+				mesh.topology = stringToMeshTopology.at(topology);
+			}
+		}
 
-					if (vertexNode.contains("tangent")) {
-						vertex.tangent = { vertexNode["tangent"][0].getNumber(), vertexNode["tangent"][1].getNumber(), vertexNode["tangent"][2].getNumber(), vertexNode["tangent"][3].getNumber() };
-						hasTangents = true;
-					}
+		void loadMeshNtmb(const std::string& filePath, Mesh& mesh) {
+			// The file is mapped, then the streams are copied from the mapping into the mesh
+			MappedFile file;
+			if (!file.open(filePath)) {
+				return;
+			}
 
-					if (vertexNode.contains("joints")) {
-						vertex.joints = std::array<uint32_t, 4>({ static_cast<uint32_t>(vertexNode["joints"][0].getNumber()), static_cast<uint32_t>(vertexNode["joints"][1].getNumber()), static_cast<uint32_t>(vertexNode["joints"][2].getNumber()), static_cast<uint32_t>(vertexNode["joints"][3].getNumber()) });
-					}
+			deserializeMeshNtmb(file.getData(), file.getSize(), filePath, mesh);
+		}
 
-					if (vertexNode.contains("weights")) {
-						vertex.weights = { vertexNode["weights"][0].getNumber(), vertexNode["weights"][1].getNumber(), vertexNode["weights"][2].getNumber(), vertexNode["weights"][3].getNumber() };
-					}
+		void deserializeMeshNtmb(const uint8_t* fileData, size_t fileSize, const std::string& filePath, Mesh& mesh) {
+			NTSHENGN_UNUSED(filePath);
+
+			if (fileSize < sizeof(MeshNtmbHeader)) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Mesh file \"" + filePath + "\" is too small to be a .ntmb file.");
+
+				return;
+			}
+
+			MeshNtmbHeader header;
+			std::memcpy(&header, fileData, sizeof(MeshNtmbHeader));
+			if ((std::memcmp(header.magic, NTMB_MAGIC, sizeof(header.magic)) != 0) || (header.version != NTMB_VERSION)) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Mesh file \"" + filePath + "\" is not a supported .ntmb file.");
+
+				return;
+			}
+			if ((header.dataSize != (fileSize - sizeof(MeshNtmbHeader))) || (header.uncompressedDataSize != getNtmbDataSize(header.vertexCount, header.indexCount, header.attributeMask)) || ((header.compression == NTMB_COMPRESSION_NONE) && (header.dataSize != header.uncompressedDataSize))) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Mesh file \"" + filePath + "\" is truncated or corrupted.");
+
+				return;
+			}
+
+			const uint8_t* data = fileData + sizeof(MeshNtmbHeader);
+			size_t dataSize = static_cast<size_t>(header.dataSize);
+			std::vector<uint8_t> uncompressedData;
+			if (header.compression == NTMB_COMPRESSION_LZ4) {
+				uncompressedData.resize(header.uncompressedDataSize);
+				if (!Compression::decompressLZ4(data, header.dataSize, uncompressedData.data(), uncompressedData.size())) {
+					NTSHENGN_ASSET_MANAGER_WARNING("Mesh file \"" + filePath + "\" could not be decompressed.");
 
-					mesh.vertices.push_back(vertex);
+					return;
 				}
+				data = uncompressedData.data();
+				dataSize = uncompressedData.size();
+			}
+			else if (header.compression != NTMB_COMPRESSION_NONE) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Mesh file \"" + filePath + "\" uses an unknown compression.");
+
+				return;
+			}
+
+			// Every vertex stream and the indices are copied from the payload
+			if (getNtmbDataSize(header.vertexCount, header.indexCount, header.attributeMask) > dataSize) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Mesh file \"" + filePath + "\" is truncated or corrupted.");
+
+				return;
 			}
 
-			if (meshRoot.contains("indices")) {
-				for (size_t i = 0; i < meshRoot["indices"].size(); i++) {
-					mesh.indices.push_back(static_cast<uint32_t>(meshRoot["indices"][i].getNumber()));
+			mesh.vertices.resize(header.vertexCount);
+			const auto readStream = [&mesh, &data](size_t offset, size_t size) {
+				for (Vertex& vertex : mesh.vertices) {
+					std::memcpy(reinterpret_cast<uint8_t*>(&vertex) + offset, data, size);
+					data += size;
+				}
+			};
+			readStream(offsetof(Vertex, position), 3 * sizeof(float));
+			for (const MeshNtmbAttribute& attribute : NTMB_ATTRIBUTES) {
+				if (header.attributeMask & attribute.bit) {
+					readStream(attribute.offset, attribute.size);
 				}
-				hasIndices = true;
 			}
+			mesh.indices.resize(header.indexCount);
+			if (header.indexCount != 0) {
+				std::memcpy(mesh.indices.data(), data, static_cast<size_t>(header.indexCount) * sizeof(uint32_t));
+			}
+
+			mesh.topology = (header.topology <= static_cast<uint32_t>(MeshTopology::Unknown)) ? static_cast<MeshTopology>(header.topology) : MeshTopology::Unknown;
 
 			// Calculate tangents
-			if ((!hasTangents) && (hasNormals && hasUvs && hasIndices)) {
+			const uint32_t tangentAttributes = NTMB_NORMAL | NTMB_UV;
+			if (!(header.attributeMask & NTMB_TANGENT) && ((header.attributeMask & tangentAttributes) == tangentAttributes) && (header.indexCount != 0)) {
 				calculateTangents(mesh);
 			}
-
-			if (meshRoot.contains("topology")) {
-				mesh.topology = stringToMeshTopology.at(meshRoot["topology"].getString());
-			}
 		}
 
+		// Samplers are parsed once per file, later loads copy the parsed sampler
 		void loadImageSamplerNtsp(const std::string& filePath, ImageSampler& imageSampler) {
+			imageSampler = m_imageSamplerCache.find_or_insert(filePath, [this, &filePath]() {
+				ImageSampler newImageSampler;
+				parseImageSamplerNtsp(filePath, newImageSampler);
+
+				return newImageSampler;
+			});
+		}
+
+		void parseImageSamplerNtsp(const std::string& filePath, ImageSampler& imageSampler) {
 			const std::unordered_map<std::string, ImageSamplerFilter> stringToImageSamplerFilter{
 				{ "Linear", ImageSamplerFilter::Linear },
 				{ "Nearest", ImageSamplerFilter::Nearest },
@@ -520,79 +3151,59 @@ namespace NtshEngn {
 			}
 		}
 
-		void loadMaterialNtml(const std::string& filePath, Material& material) {
-			JSON json;
-			const JSON::Node& materialRoot = json.read(filePath);
-
-			if (materialRoot.contains("diffuseTexture")) {
-				const JSON::Node& diffuseTextureNode = materialRoot["diffuseTexture"];
-
-				if (diffuseTextureNode.contains("imagePath")) {
-					material.diffuseTexture.image = loadImage(diffuseTextureNode["imagePath"].getString());
-				}
-
-				if (diffuseTextureNode.contains("imageSamplerPath")) {
-					loadImageSamplerNtsp(diffuseTextureNode["imageSamplerPath"].getString(), material.diffuseTexture.imageSampler);
-				}
-			}
+		// Parsed .ntml material, its images are kept as paths so that each load looks them up again and never gets an image destroyed or evicted since
+		struct ParsedMaterial {
+			Material material;
 
-			if (materialRoot.contains("normalTexture")) {
-				const JSON::Node& normalTextureNode = materialRoot["normalTexture"];
+			// In the order of getMaterialTextures, empty for textures without image
+			std::array<std::string, 6> imagePaths;
+		};
 
-				if (normalTextureNode.contains("imagePath")) {
-					material.normalTexture.image = loadImage(normalTextureNode["imagePath"].getString());
-				}
+		// Materials are parsed once per file, later loads copy the parsed material and load its images, taking their own references on them
+		void loadMaterialNtml(const std::string& filePath, Material& material) {
+			ParsedMaterial parsedMaterial;
+			if (!m_materialCache.find(filePath, parsedMaterial)) {
+				parseMaterialNtml(filePath, parsedMaterial);
 
-				if (normalTextureNode.contains("imageSamplerPath")) {
-					loadImageSamplerNtsp(normalTextureNode["imageSamplerPath"].getString(), material.normalTexture.imageSampler);
-				}
+				// Another thread may have parsed the same material in the meantime, both are the same
+				m_materialCache.insert(filePath, parsedMaterial);
 			}
 
-			if (materialRoot.contains("metalnessTexture")) {
-				const JSON::Node& metalnessTextureNode = materialRoot["metalnessTexture"];
-
-				if (metalnessTextureNode.contains("imagePath")) {
-					material.metalnessTexture.image = loadImage(metalnessTextureNode["imagePath"].getString());
-				}
-
-				if (metalnessTextureNode.contains("imageSamplerPath")) {
-					loadImageSamplerNtsp(metalnessTextureNode["imageSamplerPath"].getString(), material.metalnessTexture.imageSampler);
+			// Images load in parallel, waiting for one only runs that load, so that no unrelated job runs on the primitive job's stack
+			std::array<std::shared_future<Image*>, 6> images;
+			for (size_t i = 0; i < images.size(); i++) {
+				if (!parsedMaterial.imagePaths[i].empty()) {
+					images[i] = loadImageAsync(parsedMaterial.imagePaths[i]);
 				}
 			}
 
-			if (materialRoot.contains("roughnessTexture")) {
-				const JSON::Node& roughnessTextureNode = materialRoot["roughnessTexture"];
-
-				if (roughnessTextureNode.contains("imagePath")) {
-					material.roughnessTexture.image = loadImage(roughnessTextureNode["imagePath"].getString());
-				}
-
-				if (roughnessTextureNode.contains("imageSamplerPath")) {
-					loadImageSamplerNtsp(roughnessTextureNode["imageSamplerPath"].getString(), material.roughnessTexture.imageSampler);
+			material = parsedMaterial.material;
+			const std::array<Texture*, 6> textures = getMaterialTextures(material);
+			for (size_t i = 0; i < images.size(); i++) {
+				if (images[i].valid()) {
+					textures[i]->image = waitForLoad(parsedMaterial.imagePaths[i], images[i]);
 				}
 			}
+		}
 
-			if (materialRoot.contains("occlusionTexture")) {
-				const JSON::Node& occlusionTextureNode = materialRoot["occlusionTexture"];
-
-				if (occlusionTextureNode.contains("imagePath")) {
-					material.occlusionTexture.image = loadImage(occlusionTextureNode["imagePath"].getString());
-				}
-
-				if (occlusionTextureNode.contains("imageSamplerPath")) {
-					loadImageSamplerNtsp(occlusionTextureNode["imageSamplerPath"].getString(), material.occlusionTexture.imageSampler);
-				}
-			}
+		void parseMaterialNtml(const std::string& filePath, ParsedMaterial& parsedMaterial) {
+			JSON json;
+			const JSON::Node& materialRoot = json.read(filePath);
 
-			if (materialRoot.contains("emissiveTexture")) {
-				const JSON::Node& emissiveTextureNode = materialRoot["emissiveTexture"];
+			Material& material = parsedMaterial.material;
+			const std::array<std::string, 6> textureNames = { "diffuseTexture", "normalTexture", "metalnessTexture", "roughnessTexture", "occlusionTexture", "emissiveTexture" };
+			const std::array<Texture*, 6> textures = getMaterialTextures(material);
+			for (size_t i = 0; i < textureNames.size(); i++) {
+				if (materialRoot.contains(textureNames[i])) {
+					const JSON::Node& textureNode = materialRoot[textureNames[i]];
 
-				if (emissiveTextureNode.contains("imagePath")) {
-					material.emissiveTexture.image = loadImage(emissiveTextureNode["imagePath"].getString());
-				}
+					if (textureNode.contains("imagePath")) {
+						parsedMaterial.imagePaths[i] = textureNode["imagePath"].getString();
+					}
 
-				if (emissiveTextureNode.contains("imageSamplerPath")) {
-					loadImageSamplerNtsp(emissiveTextureNode["imageSamplerPath"].getString(), material.emissiveTexture.imageSampler);
+					if (textureNode.contains("imageSamplerPath")) {
+						loadImageSamplerNtsp(textureNode["imageSamplerPath"].getString(), textures[i]->imageSampler);
+					}
 				}
 			}
 
@@ -614,23 +3225,35 @@ namespace NtshEngn {
 			const JSON::Node& modelRoot = json.read(filePath);
 
 			if (modelRoot.contains("primitives")) {
-				for (size_t i = 0; i < modelRoot["primitives"].size(); i++) {
-					const JSON::Node& primitiveNode = modelRoot["primitives"][i];
-
-					ModelPrimitive primitive;
-					if (primitiveNode.contains("meshPath")) {
-						loadMeshNtmh(primitiveNode["meshPath"].getString(), primitive.mesh);
-					}
-					
-					if (primitiveNode.contains("materialPath")) {
-						loadMaterialNtml(primitiveNode["materialPath"].getString(), primitive.material);
+				const JSON::Node& primitivesNode = modelRoot["primitives"];
+				model.primitives.resize(primitivesNode.size());
+
+				// Each primitive is loaded by its own job, the JSON tree is read-only so jobs can share it
+				if (m_jobSystem && (primitivesNode.size() > 1)) {
+					JobCounter counter;
+					m_jobSystem->dispatch(static_cast<uint32_t>(primitivesNode.size()), 1, [this, &primitivesNode, &model](JobDispatchArguments args) {
+						loadModelPrimitive(primitivesNode[args.jobIndex], model.primitives[args.jobIndex]);
+					}, counter);
+					m_jobSystem->wait(counter);
+				}
+				else {
+					for (size_t i = 0; i < primitivesNode.size(); i++) {
+						loadModelPrimitive(primitivesNode[i], model.primitives[i]);
 					}
-
-					model.primitives.push_back(primitive);
 				}
 			}
 		}
 
+		void loadModelPrimitive(const JSON::Node& primitiveNode, ModelPrimitive& primitive) {
+			if (primitiveNode.contains("meshPath")) {
+				loadMesh(primitiveNode["meshPath"].getString(), primitive.mesh);
+			}
+
+			if (primitiveNode.contains("materialPath")) {
+				loadMaterialNtml(primitiveNode["materialPath"].getString(), primitive.material);
+			}
+		}
+
 		void loadImageNtim(const std::string& filePath, Image& image) {
 			const std::unordered_map<std::string, ImageFormat> stringToImageFormat{
 				{ "R8", ImageFormat::R8 },
@@ -645,6 +3268,13 @@ namespace NtshEngn {
 				{ "R32G32", ImageFormat::R32G32 },
 				{ "R32G32B32", ImageFormat::R32G32B32 },
 				{ "R32G32B32A32", ImageFormat::R32G32B32A32 },
+				{ "BC1RGB", ImageFormat::BC1RGB },
+				{ "BC1RGBA", ImageFormat::BC1RGBA },
+				{ "BC3RGBA", ImageFormat::BC3RGBA },
+				{ "BC4R", ImageFormat::BC4R },
+				{ "BC5RG", ImageFormat::BC5RG },
+				{ "BC6HRGBUFloat", ImageFormat::BC6HRGBUFloat },
+				{ "BC7RGBA", ImageFormat::BC7RGBA },
 				{ "Unknown", ImageFormat::Unknown }
 			};
 			const std::unordered_map<std::string, ImageColorSpace> stringToImageColorSpace{
@@ -653,40 +3283,154 @@ namespace NtshEngn {
 				{ "Unknown", ImageColorSpace::Unknown }
 			};
 
-			JSON json;
-			const JSON::Node& imageRoot = json.read(filePath);
+			// Binary .ntim files start with a magic number instead of a JSON object
+			{
+				std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+				if (!file->open(filePath)) {
+					return;
+				}
+				if ((file->getSize() >= sizeof(NTIM_MAGIC)) && (std::memcmp(file->getData(), NTIM_MAGIC, sizeof(NTIM_MAGIC)) == 0)) {
+					deserializeImageNtim(file->getData(), file->getSize(), file, filePath, image);
+
+					return;
+				}
+			}
+
+			// Image data can be large, stream it straight into the image instead of building a JSON tree
+			JSON::Reader imageReader;
+			if (!imageReader.open(filePath) || (imageReader.next() != JSON::Reader::Event::ObjectStart)) {
+				return;
+			}
+
+			while (imageReader.next() == JSON::Reader::Event::Key) {
+				const std::string_view key = imageReader.getString();
 
-			if (imageRoot.contains("width")) {
-				image.width = static_cast<uint32_t>(imageRoot["width"].getNumber());
+				if (key == "width") {
+					image.width = static_cast<uint32_t>(imageReader.readInt());
+				}
+				else if (key == "height") {
+					image.height = static_cast<uint32_t>(imageReader.readInt());
+				}
+				else if (key == "format") {
+					image.format = stringToImageFormat.at(imageReader.readString());
+				}
+				else if (key == "colorSpace") {
+					image.colorSpace = stringToImageColorSpace.at(imageReader.readString());
+				}
+				else if (key == "mipLevelCount") {
+					image.mipLevelCount = static_cast<uint32_t>(imageReader.readInt());
+				}
+				else if (key == "data") {
+					imageReader.readNumberArray(image.data);
+				}
+				else {
+					imageReader.skipValue();
+				}
+			}
+		}
+
+		// fileData can be referenced by the image when it ends with mappedFile
+		void deserializeImageNtim(const uint8_t* fileData, size_t fileSize, const std::shared_ptr<MappedFile>& mappedFile, const std::string& filePath, Image& image) {
+			NTSHENGN_UNUSED(filePath);
+
+			if (fileSize < sizeof(ImageNtimHeader)) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Image file \"" + filePath + "\" is too small to be a binary .ntim file.");
+
+				return;
 			}
-			if (imageRoot.contains("height")) {
-				image.height = static_cast<uint32_t>(imageRoot["height"].getNumber());
+
+			ImageNtimHeader header;
+			std::memcpy(&header, fileData, sizeof(ImageNtimHeader));
+			if ((header.version != NTIM_VERSION) || (header.format > static_cast<uint32_t>(ImageFormat::Unknown)) || (header.colorSpace > static_cast<uint32_t>(ImageColorSpace::Unknown))) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Image file \"" + filePath + "\" is not a supported binary .ntim file.");
+
+				return;
+			}
+			const ImageFormat format = static_cast<ImageFormat>(header.format);
+			// The pixel count is bounded first so that the expected data size cannot overflow
+			if ((header.dataSize != (fileSize - sizeof(ImageNtimHeader))) || (header.mipLevelCount == 0) || (header.mipLevelCount > getImageMaxMipLevelCount(header.width, header.height)) || ((static_cast<uint64_t>(header.width) * header.height) > (std::numeric_limits<uint64_t>::max() / 64))) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Image file \"" + filePath + "\" is truncated or corrupted.");
+
+				return;
 			}
-			if (imageRoot.contains("format")) {
-				image.format = stringToImageFormat.at(imageRoot["format"].getString());
+
+			// Uncompressed payloads are used as they are, so they must hold every mip level
+			const size_t imageDataSize = getImageDataSize(format, header.width, header.height, header.mipLevelCount);
+			if ((header.uncompressedDataSize != imageDataSize) || ((header.compression == NTIM_COMPRESSION_NONE) && (header.dataSize != imageDataSize))) {
+				NTSHENGN_ASSET_MANAGER_WARNING("Image file \"" + filePath + "\" is truncated or corrupted.");
+
+				return;
 			}
-			if (imageRoot.contains("colorSpace")) {
-				image.colorSpace = stringToImageColorSpace.at(imageRoot["colorSpace"].getString());
+
+			// Uncompressed payloads are either referenced in the mapped file or copied from it, compressed ones are decompressed straight into the image
+			const uint8_t* data = fileData + sizeof(ImageNtimHeader);
+			if (header.compression == NTIM_COMPRESSION_NONE) {
+				if (m_mapImageFiles && mappedFile && ((fileData + fileSize) == (mappedFile->getData() + mappedFile->getSize()))) {
+					image.mappedFile = mappedFile;
+					image.mappedData = data;
+					image.mappedDataSize = static_cast<size_t>(header.dataSize);
+				}
+				else {
+					image.data.assign(data, data + header.dataSize);
+				}
 			}
-			if (imageRoot.contains("data")) {
-				for (size_t i = 0; i < imageRoot["data"].size(); i++) {
-					image.data.push_back(static_cast<uint8_t>(imageRoot["data"][i].getNumber()));
+			else if (header.compression == NTIM_COMPRESSION_LZ4) {
+				image.data.resize(header.uncompressedDataSize);
+				if (!Compression::decompressLZ4(data, header.dataSize, image.data.data(), image.data.size())) {
+					NTSHENGN_ASSET_MANAGER_WARNING("Image file \"" + filePath + "\" could not be decompressed.");
+					image.data.clear();
+
+					return;
 				}
 			}
+			else {
+				NTSHENGN_ASSET_MANAGER_WARNING("Image file \"" + filePath + "\" uses an unknown compression.");
+				image.data.clear();
+
+				return;
+			}
+
+			image.width = header.width;
+			image.height = header.height;
+			image.format = format;
+			image.colorSpace = static_cast<ImageColorSpace>(header.colorSpace);
+			image.mipLevelCount = header.mipLevelCount;
 		}
 
 	private:
 		AssetLoaderModuleInterface* m_assetLoaderModule;
+		JobSystem* m_jobSystem = nullptr;
+
+		bool m_mapImageFiles = false;
+		bool m_optimizeMeshes = false;
+		uint32_t m_lodCount = 0;
+		bool m_buildMeshlets = false;
 
-		std::forward_list<Sound> m_soundResources;
-		std::forward_list<Model> m_modelResources;
-		std::forward_list<Image> m_imageResources;
-		std::forward_list<Font> m_fontResources;
+		std::string m_cacheDirectory;
+
+		ConcurrentHashMap<std::string, ImageSampler> m_imageSamplerCache;
+		ConcurrentHashMap<std::string, ParsedMaterial> m_materialCache;
+
+		SlotMap<Sound> m_soundResources;
+		SlotMap<Model> m_modelResources;
+		SlotMap<Image> m_imageResources;
+		SlotMap<Font> m_fontResources;
 
 		Bimap<std::string, Sound*> m_soundPaths;
 		Bimap<std::string, Model*> m_modelPaths;
 		Bimap<std::string, Image*> m_imagePaths;
 		Bimap<std::string, Font*> m_fontPaths;
+
+		ResourceCache<Sound> m_soundCache;
+		ResourceCache<Model> m_modelCache;
+		ResourceCache<Image> m_imageCache;
+		ResourceCache<Font> m_fontCache;
+
+		std::mutex m_pendingLoadsMutex;
+		std::unordered_map<std::string, PendingLoad<Sound>> m_pendingSoundLoads;
+		std::unordered_map<std::string, PendingLoad<Model>> m_pendingModelLoads;
+		std::unordered_map<std::string, PendingLoad<Image>> m_pendingImageLoads;
+		std::unordered_map<std::string, PendingLoad<Font>> m_pendingFontLoads;
 	};
 
 }
\ No newline at end of file
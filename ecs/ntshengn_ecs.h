@@ -1,6 +1,7 @@
 #pragma once
 #include "../utils/ntshengn_defines.h"
 #include "../utils/ntshengn_utils_bimap.h"
+#include "../utils/ntshengn_utils_concurrent_hash_map.h"
 #include "components/ntshengn_ecs_transform.h"
 #include "components/ntshengn_ecs_renderable.h"
 #include "components/ntshengn_ecs_camera.h"
@@ -17,6 +18,7 @@
 #include <set>
 #include <string>
 #include <algorithm>
+#include <atomic>
 
 #define MAX_ENTITIES 4096
 #define MAX_COMPONENTS 32
@@ -212,20 +214,22 @@ namespace NtshEngn {
 		void registerComponent() {
 			std::string typeName = std::string(typeid(T).name());
 
-			NTSHENGN_ASSERT(m_componentTypes.find(typeName) == m_componentTypes.end());
+			NTSHENGN_ASSERT(!m_componentTypes.exist(typeName));
 
-			m_componentTypes.insert({ typeName, m_nextComponent });
-			m_componentArrays.insert({ typeName, std::make_shared<ComponentArray<T>>() });
-			m_nextComponent++;
+			m_componentArrays.insert(typeName, std::make_shared<ComponentArray<T>>());
+			m_componentTypes.insert(typeName, m_nextComponent.fetch_add(1));
 		}
 
 		template <typename T>
 		Component getComponentID() {
 			std::string typeName = std::string(typeid(T).name());
 
-			NTSHENGN_ASSERT(m_componentTypes.find(typeName) != m_componentTypes.end());
+			Component componentID = 0;
+			const bool componentRegistered = m_componentTypes.find(typeName, componentID);
+			NTSHENGN_ASSERT(componentRegistered);
+			NTSHENGN_UNUSED(componentRegistered);
 
-			return m_componentTypes[typeName];
+			return componentID;
 		}
 
 		template <typename T>
@@ -249,24 +253,27 @@ namespace NtshEngn {
 		}
 
 		void entityDestroyed(Entity entity) {
-			for (const auto& pair : m_componentArrays) {
-				const std::shared_ptr<IComponentArray>& componentArray = pair.second;
+			m_componentArrays.for_each([entity](const std::string& typeName, const std::shared_ptr<IComponentArray>& componentArray) {
+				NTSHENGN_UNUSED(typeName);
 				componentArray->entityDestroyed(entity);
-			}
+			});
 		}
 
 	private:
-		std::unordered_map<std::string, Component> m_componentTypes;
-		std::unordered_map<std::string, std::shared_ptr<IComponentArray>> m_componentArrays;
-		Component m_nextComponent = 0;
+		ConcurrentHashMap<std::string, Component> m_componentTypes;
+		ConcurrentHashMap<std::string, std::shared_ptr<IComponentArray>> m_componentArrays;
+		std::atomic<Component> m_nextComponent{ 0 };
 
 		template <typename T>
 		std::shared_ptr<ComponentArray<T>> getComponentArray() {
 			std::string typeName = std::string(typeid(T).name());
 
-			NTSHENGN_ASSERT(m_componentTypes.find(typeName) != m_componentTypes.end());
+			std::shared_ptr<IComponentArray> componentArray;
+			const bool componentRegistered = m_componentArrays.find(typeName, componentArray);
+			NTSHENGN_ASSERT(componentRegistered);
+			NTSHENGN_UNUSED(componentRegistered);
 
-			return std::static_pointer_cast<ComponentArray<T>>(m_componentArrays[typeName]);
+			return std::static_pointer_cast<ComponentArray<T>>(componentArray);
 		}
 	};
 
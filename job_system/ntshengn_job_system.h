@@ -5,7 +5,9 @@
 #include <condition_variable>
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <algorithm>
+#include <vector>
 #include <cstdint>
 
 namespace NtshEngn {
@@ -18,6 +20,13 @@ namespace NtshEngn {
 		bool running;
 	};
 
+	// Counts the unfinished jobs of a group so that JobSystem::wait can wait on that group only
+	// The group's jobs are queued here and the shared queue gets one job per group job running the next one, so that a thread waiting on the group can run the group's jobs only
+	struct JobCounter {
+		std::atomic<uint32_t> pendingJobs{ 0 };
+		std::shared_ptr<ThreadSafeQueue<std::function<void()>>> jobQueue = std::make_shared<ThreadSafeQueue<std::function<void()>>>();
+	};
+
 	struct JobDispatchArguments {
 		uint32_t workerIndex;
 		uint32_t jobIndex;
@@ -32,14 +41,8 @@ namespace NtshEngn {
 
 			for (uint32_t threadID = 0; threadID < m_numThreads; threadID++) {
 				m_threads.emplace_back([&sharedData = m_sharedData]() {
-					std::function<void()> job;
-
 					while (sharedData.running) {
-						if (sharedData.jobQueue.pop_front(job)) {
-							job();
-							sharedData.currentJobs.fetch_sub(1);
-						}
-						else {
+						if (!runPendingJob(sharedData)) {
 							std::unique_lock<std::mutex> lock(sharedData.wakeMutex);
 							sharedData.wakeCondition.wait(lock);
 						}
@@ -64,50 +67,270 @@ namespace NtshEngn {
 			m_sharedData.wakeCondition.notify_one();
 		}
 
+		// Executes job as part of the group tracked by counter
+		void execute(const std::function<void()>& job, JobCounter& counter) {
+			counter.pendingJobs.fetch_add(1);
+
+			counter.jobQueue->push_back([job, &counter]() {
+				job();
+				counter.pendingJobs.fetch_sub(1);
+			});
+			execute(getGroupJobRunner(counter.jobQueue));
+		}
+
 		void dispatch(uint32_t jobCount, uint32_t jobsPerWorker, const std::function<void(JobDispatchArguments)>& job) {
+			dispatch(jobCount, jobsPerWorker, job, nullptr);
+		}
+
+		// Dispatches job as part of the group tracked by counter
+		void dispatch(uint32_t jobCount, uint32_t jobsPerWorker, const std::function<void(JobDispatchArguments)>& job, JobCounter& counter) {
+			dispatch(jobCount, jobsPerWorker, job, &counter);
+		}
+
+		// Number of workers a dispatch of jobCount jobs with jobsPerWorker jobs per worker will use, to size per-worker scratch storage
+		static uint32_t getDispatchWorkerCount(uint32_t jobCount, uint32_t jobsPerWorker) {
 			if ((jobCount == 0) || (jobsPerWorker == 0)) {
-				return;
+				return 0;
 			}
 
-			const uint32_t workerCount = (jobCount + jobsPerWorker - 1) / jobsPerWorker;
+			return (jobCount + jobsPerWorker - 1) / jobsPerWorker;
+		}
 
-			m_sharedData.currentJobs.fetch_add(workerCount);
+		// Reduces map(jobIndex) for every job with operation, operation must be associative and identity must be its neutral element
+		template <typename T>
+		T parallelReduce(uint32_t jobCount, uint32_t jobsPerWorker, const T& identity, const std::function<T(uint32_t)>& map, const std::function<T(const T&, const T&)>& operation) {
+			const uint32_t workerCount = getDispatchWorkerCount(jobCount, jobsPerWorker);
+			if (workerCount == 0) {
+				return identity;
+			}
 
-			for (uint32_t workerIndex = 0; workerIndex < workerCount; workerIndex++) {
-				const uint32_t workerJobOffset = workerIndex * jobsPerWorker;
-				const uint32_t workerJobEnd = std::min(workerJobOffset + jobsPerWorker, jobCount);
+			std::vector<WorkerSlot<T>> workerResults(workerCount, WorkerSlot<T>{ identity });
+			JobCounter counter;
+			dispatch(jobCount, jobsPerWorker, [&workerResults, &map, &operation](JobDispatchArguments args) {
+				T& workerResult = workerResults[args.workerIndex].value;
+				workerResult = operation(workerResult, map(args.jobIndex));
+			}, counter);
+			wait(counter);
 
-				std::function<void()> dispatchJobForWorker = [workerJobOffset, workerJobEnd, workerIndex, job]() {
-					JobDispatchArguments dispatchArguments;
-					dispatchArguments.workerIndex = workerIndex;
+			T result = identity;
+			for (const WorkerSlot<T>& workerResult : workerResults) {
+				result = operation(result, workerResult.value);
+			}
 
-					for (uint32_t jobIndex = workerJobOffset; jobIndex < workerJobEnd; jobIndex++) {
-						dispatchArguments.jobIndex = jobIndex;
+			return result;
+		}
 
-						job(dispatchArguments);
+		// In-place prefix scan of elements with operation, inclusive if element i includes itself, exclusive otherwise
+		template <typename T>
+		void parallelScan(std::vector<T>& elements, uint32_t elementsPerWorker, const T& identity, const std::function<T(const T&, const T&)>& operation, bool inclusive = true) {
+			const uint32_t elementCount = static_cast<uint32_t>(elements.size());
+			const uint32_t workerCount = getDispatchWorkerCount(elementCount, elementsPerWorker);
+			if (workerCount == 0) {
+				return;
+			}
+
+			// Reduce each worker's range
+			std::vector<WorkerSlot<T>> workerOffsets(workerCount, WorkerSlot<T>{ identity });
+			JobCounter counter;
+			dispatch(workerCount, 1, [&elements, &workerOffsets, &operation, elementCount, elementsPerWorker](JobDispatchArguments args) {
+				const uint32_t begin = args.jobIndex * elementsPerWorker;
+				const uint32_t end = std::min(begin + elementsPerWorker, elementCount);
+
+				T sum = workerOffsets[args.jobIndex].value;
+				for (uint32_t i = begin; i < end; i++) {
+					sum = operation(sum, elements[i]);
+				}
+				workerOffsets[args.jobIndex].value = sum;
+			}, counter);
+			wait(counter);
+
+			// Exclusive scan of the worker sums gives each worker its starting offset
+			T runningOffset = identity;
+			for (WorkerSlot<T>& workerOffset : workerOffsets) {
+				const T workerSum = workerOffset.value;
+				workerOffset.value = runningOffset;
+				runningOffset = operation(runningOffset, workerSum);
+			}
+
+			// Scan each worker's range starting from its offset
+			dispatch(workerCount, 1, [&elements, &workerOffsets, &operation, elementCount, elementsPerWorker, inclusive](JobDispatchArguments args) {
+				const uint32_t begin = args.jobIndex * elementsPerWorker;
+				const uint32_t end = std::min(begin + elementsPerWorker, elementCount);
+
+				T sum = workerOffsets[args.jobIndex].value;
+				for (uint32_t i = begin; i < end; i++) {
+					if (inclusive) {
+						sum = operation(sum, elements[i]);
+						elements[i] = sum;
+					}
+					else {
+						const T element = elements[i];
+						elements[i] = sum;
+						sum = operation(sum, element);
 					}
-				};
+				}
+			}, counter);
+			wait(counter);
+		}
 
-				m_sharedData.jobQueue.push_back(dispatchJobForWorker);
+		// Sorts each worker's range in parallel then merges neighbouring ranges pairwise in parallel
+		template <typename T>
+		void parallelSort(std::vector<T>& elements, uint32_t elementsPerWorker, const std::function<bool(const T&, const T&)>& compare) {
+			const uint32_t elementCount = static_cast<uint32_t>(elements.size());
+			const uint32_t workerCount = getDispatchWorkerCount(elementCount, elementsPerWorker);
+			if (workerCount == 0) {
+				return;
+			}
 
-				m_sharedData.wakeCondition.notify_one();
+			JobCounter counter;
+			dispatch(workerCount, 1, [&elements, &compare, elementCount, elementsPerWorker](JobDispatchArguments args) {
+				const uint32_t begin = args.jobIndex * elementsPerWorker;
+				const uint32_t end = std::min(begin + elementsPerWorker, elementCount);
+
+				std::sort(elements.begin() + begin, elements.begin() + end, compare);
+			}, counter);
+			wait(counter);
+
+			for (size_t runSize = elementsPerWorker; runSize < elementCount; runSize *= 2) {
+				const uint32_t mergeCount = static_cast<uint32_t>((elementCount + (runSize * 2) - 1) / (runSize * 2));
+
+				dispatch(mergeCount, 1, [&elements, &compare, elementCount, runSize](JobDispatchArguments args) {
+					const size_t begin = args.jobIndex * runSize * 2;
+					const size_t middle = std::min<size_t>(begin + runSize, elementCount);
+					const size_t end = std::min<size_t>(middle + runSize, elementCount);
+
+					if (middle < end) {
+						std::inplace_merge(elements.begin() + begin, elements.begin() + middle, elements.begin() + end, compare);
+					}
+				}, counter);
+				wait(counter);
 			}
 		}
 
 		bool isBusy() {
 			return m_sharedData.currentJobs.load() != 0;
 		}
+
+		bool isBusy(const JobCounter& counter) {
+			return counter.pendingJobs.load() != 0;
+		}
 		
+		// Waits for every job, the calling thread executes pending jobs meanwhile
+		// Must not be called from inside a job, as the calling job would wait for itself
 		void wait() {
 			while (isBusy()) {
-				std::this_thread::yield();
+				if (!runPendingJob(m_sharedData)) {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		// Waits for the jobs of the group tracked by counter, the calling thread executes the group's pending jobs meanwhile
+		// Can be called from inside a job as only the group's jobs run on the waiting job's stack, which must then not wait, directly or not, for a group holding the waiting job
+		void wait(const JobCounter& counter) {
+			while (isBusy(counter)) {
+				if (!runGroupJob(counter)) {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		// Executes one pending job of the group tracked by counter on the calling thread, returns false if there was none
+		// Lets a thread wait for something a group's jobs produce without running unrelated jobs on its stack, as wait(counter) does
+		bool runGroupJob(const JobCounter& counter) {
+			std::function<void()> job;
+			if (!counter.jobQueue->pop_front(job)) {
+				return false;
 			}
+
+			job();
+
+			return true;
 		}
 
 		uint32_t getNumThreads() const {
 			return m_numThreads;
 		}
 
+	private:
+		// Per-worker result on its own cache line, so that workers neither share words (std::vector<bool>) nor cache lines
+		template <typename T>
+		struct alignas(64) WorkerSlot {
+			T value;
+		};
+
+		static bool runPendingJob(JobSharedData& sharedData) {
+			std::function<void()> job;
+			if (!sharedData.jobQueue.pop_front(job)) {
+				return false;
+			}
+
+			job();
+			sharedData.currentJobs.fetch_sub(1);
+
+			return true;
+		}
+
+		// Runs the next job of a group unless a thread waiting on the group already ran it
+		static std::function<void()> getGroupJobRunner(const std::shared_ptr<ThreadSafeQueue<std::function<void()>>>& groupJobQueue) {
+			return [groupJobQueue]() {
+				std::function<void()> job;
+				if (groupJobQueue->pop_front(job)) {
+					job();
+				}
+			};
+		}
+
+		void dispatch(uint32_t jobCount, uint32_t jobsPerWorker, const std::function<void(JobDispatchArguments)>& job, JobCounter* counter) {
+			if ((jobCount == 0) || (jobsPerWorker == 0)) {
+				return;
+			}
+
+			const uint32_t workerCount = (jobCount + jobsPerWorker - 1) / jobsPerWorker;
+
+			m_sharedData.currentJobs.fetch_add(workerCount);
+			if (counter) {
+				counter->pendingJobs.fetch_add(workerCount);
+			}
+
+			std::vector<std::function<void()>> dispatchJobs;
+			dispatchJobs.reserve(workerCount);
+			for (uint32_t workerIndex = 0; workerIndex < workerCount; workerIndex++) {
+				const uint32_t workerJobOffset = workerIndex * jobsPerWorker;
+				const uint32_t workerJobEnd = std::min(workerJobOffset + jobsPerWorker, jobCount);
+
+				dispatchJobs.emplace_back([workerJobOffset, workerJobEnd, workerIndex, job, counter]() {
+					JobDispatchArguments dispatchArguments;
+					dispatchArguments.workerIndex = workerIndex;
+
+					for (uint32_t jobIndex = workerJobOffset; jobIndex < workerJobEnd; jobIndex++) {
+						dispatchArguments.jobIndex = jobIndex;
+
+						job(dispatchArguments);
+					}
+
+					if (counter) {
+						counter->pendingJobs.fetch_sub(1);
+					}
+				});
+			}
+
+			if (counter) {
+				counter->jobQueue->push_bulk(dispatchJobs.data(), dispatchJobs.size());
+				for (std::function<void()>& dispatchJob : dispatchJobs) {
+					dispatchJob = getGroupJobRunner(counter->jobQueue);
+				}
+			}
+			m_sharedData.jobQueue.push_bulk(dispatchJobs.data(), dispatchJobs.size());
+
+			if (workerCount == 1) {
+				m_sharedData.wakeCondition.notify_one();
+			}
+			else {
+				m_sharedData.wakeCondition.notify_all();
+			}
+		}
+
 	private:
 		uint32_t m_numThreads = 0;
 		std::vector<std::thread> m_threads;
@@ -4,9 +4,13 @@
 #include <array>
 #include <vector>
 #include <unordered_map>
+#include <memory>
 
 namespace NtshEngn {
 
+	// Defined in utils/ntshengn_utils_mapped_file.h, kept out of this header as it includes the platform headers
+	class MappedFile;
+
 	// Image
 	typedef uint32_t ImageID;
 	#define NTSHENGN_IMAGE_UNKNOWN 0xFFFFFFFF
@@ -24,6 +28,13 @@ namespace NtshEngn {
 		R32G32,
 		R32G32B32,
 		R32G32B32A32,
+		BC1RGB,
+		BC1RGBA,
+		BC3RGBA,
+		BC4R,
+		BC5RG,
+		BC6HRGBUFloat,
+		BC7RGBA,
 		Unknown
 	};
 
@@ -70,8 +81,24 @@ namespace NtshEngn {
 		// Image color space
 		ImageColorSpace colorSpace = ImageColorSpace::Unknown;
 
-		// Data
+		// Number of mip levels in data, level 0 being the full size image
+		uint32_t mipLevelCount = 1;
+
+		// Data, mip levels one after the other, block compressed formats are stored as 4x4 blocks
 		std::vector<uint8_t> data;
+
+		// Data loaded without copy, mappedDataSize bytes at mappedData in the mapped file, which mappedFile keeps alive, used instead of data when set
+		std::shared_ptr<const MappedFile> mappedFile;
+		const uint8_t* mappedData = nullptr;
+		size_t mappedDataSize = 0;
+
+		const uint8_t* getData() const {
+			return mappedFile ? mappedData : data.data();
+		}
+
+		size_t getDataSize() const {
+			return mappedFile ? mappedDataSize : data.size();
+		}
 	};
 
 	// Image Sampler
@@ -206,17 +233,119 @@ namespace NtshEngn {
 		Math::mat4 inverseGlobalTransform;
 	};
 
+	// Meshlet
+	// Cluster of neighbouring triangles of a mesh
+	struct Meshlet {
+		// Offsets in Mesh::meshletVertices and Mesh::meshletTriangles
+		uint32_t vertexOffset = 0;
+		uint32_t vertexCount = 0;
+		uint32_t triangleOffset = 0;
+		uint32_t triangleCount = 0;
+
+		Math::vec3 boundingSphereCenter;
+		float boundingSphereRadius = 0.0f;
+
+		// All triangles face away from a camera at cameraPosition when dot(boundingSphereCenter - cameraPosition, coneAxis) >= coneCutoff * length(boundingSphereCenter - cameraPosition) + boundingSphereRadius
+		// A cutoff of 1 never culls
+		Math::vec3 coneAxis;
+		float coneCutoff = 1.0f;
+	};
+
+	// Bounds of a mesh's vertex positions
+	struct MeshBounds {
+		Math::vec3 aabbMin;
+		Math::vec3 aabbMax;
+
+		Math::vec3 boundingSphereCenter;
+		float boundingSphereRadius = 0.0f;
+
+		// Set by AssetManager::updateMeshBounds and used by AssetManager::getMeshBounds, must be reset when the positions change
+		bool valid = false;
+	};
+
 	struct Mesh {
 		std::vector<Vertex> vertices;
 		std::vector<uint32_t> indices;
 		Skin skin;
 		MeshTopology topology = MeshTopology::Unknown;
+		MeshBounds bounds;
+
+		// Optional, meshletVertices are indices in vertices and meshletTriangles are 3 indices per triangle in the meshlet's vertices
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> meshletVertices;
+		std::vector<uint8_t> meshletTriangles;
+	};
+
+	// Packed mesh
+	enum class VertexAttribute {
+		Position,
+		Normal,
+		UV,
+		Color,
+		Tangent,
+		Joints,
+		Weights,
+		Count
+	};
+
+	enum class VertexAttributeFormat {
+		None,
+		Float32x2,
+		Float32x3,
+		Float32x4,
+		Float16x2,
+		Float16x4,
+		Octahedral16x2, // Unit vector, two snorm16
+		Snorm8x4,
+		Snorm16x4,
+		Unorm8x4,
+		Unorm16x4,
+		Uint8x4,
+		Uint16x4,
+		Uint32x4
+	};
+
+	// Attributes are interleaved in VertexAttribute order, attributes in VertexAttributeFormat::None are not stored
+	struct VertexLayout {
+		std::array<VertexAttributeFormat, static_cast<size_t>(VertexAttribute::Count)> formats = { VertexAttributeFormat::Float32x3, VertexAttributeFormat::None, VertexAttributeFormat::None, VertexAttributeFormat::None, VertexAttributeFormat::None, VertexAttributeFormat::None, VertexAttributeFormat::None };
+
+		// Offset of each attribute in a vertex
+		std::array<uint32_t, static_cast<size_t>(VertexAttribute::Count)> offsets = { 0, 0, 0, 0, 0, 0, 0 };
+
+		// Size of a vertex
+		uint32_t stride = 0;
+	};
+
+	// Mesh with its vertices packed following a vertex layout
+	struct PackedMesh {
+		VertexLayout vertexLayout;
+		uint32_t vertexCount = 0;
+		std::vector<uint8_t> vertices;
+
+		// 2 when every index fits in 16 bits, 4 otherwise
+		uint32_t indexSize = sizeof(uint32_t);
+		uint32_t indexCount = 0;
+		std::vector<uint8_t> indices;
+
+		Skin skin;
+		MeshTopology topology = MeshTopology::Unknown;
 	};
 
 	// Model
+	// Simplified version of a primitive's mesh, using its vertices
+	struct ModelPrimitiveLOD {
+		std::vector<uint32_t> indices;
+
+		// Used when the primitive's AABB covers less than this fraction of the screen height
+		float screenSize = 1.0f;
+	};
+
 	struct ModelPrimitive {
 		Mesh mesh;
 		Material material;
+
+		// From the most to the least detailed, the mesh is used above the first LOD's screen size
+		std::vector<ModelPrimitiveLOD> lods;
 	};
 
 	struct Model {
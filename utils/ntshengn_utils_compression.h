@@ -0,0 +1,172 @@
+#pragma once
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace NtshEngn {
+
+	// Byte-oriented LZ77 compression using the LZ4 block format, decompression only copies literals and earlier output so it runs close to memory speed
+	class Compression {
+	public:
+		// Appends the compressed data to compressedData
+		static void compressLZ4(const uint8_t* data, size_t size, std::vector<uint8_t>& compressedData) {
+			compressedData.reserve(compressedData.size() + getMaxCompressedSize(size));
+
+			std::vector<uint32_t> hashTable(HASH_TABLE_SIZE, 0);
+
+			size_t literalStart = 0;
+			size_t position = 0;
+			// The block format requires the last match to start at least 12 bytes before the end and the last 5 bytes to be literals
+			const size_t matchLimit = (size > LAST_LITERALS) ? (size - LAST_LITERALS) : 0;
+			const size_t matchStartLimit = (size > MIN_END_DISTANCE) ? (size - MIN_END_DISTANCE) : 0;
+			while (position < matchStartLimit) {
+				const uint32_t sequence = read32(data + position);
+				const uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+				const size_t candidate = static_cast<size_t>(hashTable[hash]);
+				hashTable[hash] = static_cast<uint32_t>(position);
+
+				if ((candidate >= position) || ((position - candidate) > MAX_OFFSET) || (read32(data + candidate) != sequence)) {
+					position++;
+					continue;
+				}
+
+				size_t matchLength = MIN_MATCH;
+				while (((position + matchLength) < matchLimit) && (data[candidate + matchLength] == data[position + matchLength])) {
+					matchLength++;
+				}
+
+				writeSequence(data + literalStart, position - literalStart, static_cast<uint16_t>(position - candidate), matchLength, compressedData);
+
+				position += matchLength;
+				literalStart = position;
+			}
+
+			writeLastLiterals(data + literalStart, size - literalStart, compressedData);
+		}
+
+		// Decompresses exactly size bytes into data, returns false if the compressed data is malformed or does not decompress to size bytes
+		static bool decompressLZ4(const uint8_t* compressedData, size_t compressedSize, uint8_t* data, size_t size) {
+			const uint8_t* current = compressedData;
+			const uint8_t* end = compressedData + compressedSize;
+			uint8_t* output = data;
+			uint8_t* outputEnd = data + size;
+
+			while (current < end) {
+				const uint8_t token = *current++;
+
+				size_t literalLength = static_cast<size_t>(token >> 4);
+				if ((literalLength == 15) && !readLength(current, end, literalLength)) {
+					return false;
+				}
+				if ((literalLength > static_cast<size_t>(end - current)) || (literalLength > static_cast<size_t>(outputEnd - output))) {
+					return false;
+				}
+				std::memcpy(output, current, literalLength);
+				output += literalLength;
+				current += literalLength;
+
+				// The last sequence has no match
+				if (current == end) {
+					break;
+				}
+
+				if ((end - current) < 2) {
+					return false;
+				}
+				const size_t offset = static_cast<size_t>(current[0]) | (static_cast<size_t>(current[1]) << 8);
+				current += 2;
+				if ((offset == 0) || (offset > static_cast<size_t>(output - data))) {
+					return false;
+				}
+
+				size_t matchLength = static_cast<size_t>(token & 15);
+				if ((matchLength == 15) && !readLength(current, end, matchLength)) {
+					return false;
+				}
+				matchLength += MIN_MATCH;
+				if (matchLength > static_cast<size_t>(outputEnd - output)) {
+					return false;
+				}
+
+				const uint8_t* match = output - offset;
+				if (offset >= matchLength) {
+					std::memcpy(output, match, matchLength);
+					output += matchLength;
+				}
+				else {
+					// Overlapping match, repeats the last offset bytes
+					for (size_t i = 0; i < matchLength; i++) {
+						*output++ = *match++;
+					}
+				}
+			}
+
+			return output == outputEnd;
+		}
+
+		static size_t getMaxCompressedSize(size_t size) {
+			return size + (size / 255) + 16;
+		}
+
+	private:
+		static constexpr size_t HASH_BITS = 16;
+		static constexpr size_t HASH_TABLE_SIZE = static_cast<size_t>(1) << HASH_BITS;
+		static constexpr size_t MIN_MATCH = 4;
+		static constexpr size_t MAX_OFFSET = 65535;
+		static constexpr size_t LAST_LITERALS = 5;
+		static constexpr size_t MIN_END_DISTANCE = 12;
+
+		static uint32_t read32(const uint8_t* data) {
+			uint32_t value;
+			std::memcpy(&value, data, sizeof(uint32_t));
+
+			return value;
+		}
+
+		static void writeLength(size_t length, std::vector<uint8_t>& compressedData) {
+			while (length >= 255) {
+				compressedData.push_back(255);
+				length -= 255;
+			}
+			compressedData.push_back(static_cast<uint8_t>(length));
+		}
+
+		static bool readLength(const uint8_t*& current, const uint8_t* end, size_t& length) {
+			uint8_t byte;
+			do {
+				if (current == end) {
+					return false;
+				}
+				byte = *current++;
+				length += byte;
+			} while (byte == 255);
+
+			return true;
+		}
+
+		static void writeSequence(const uint8_t* literals, size_t literalLength, uint16_t offset, size_t matchLength, std::vector<uint8_t>& compressedData) {
+			const size_t encodedMatchLength = matchLength - MIN_MATCH;
+			const uint8_t token = static_cast<uint8_t>(((literalLength < 15) ? literalLength : 15) << 4) | static_cast<uint8_t>((encodedMatchLength < 15) ? encodedMatchLength : 15);
+			compressedData.push_back(token);
+			if (literalLength >= 15) {
+				writeLength(literalLength - 15, compressedData);
+			}
+			compressedData.insert(compressedData.end(), literals, literals + literalLength);
+			compressedData.push_back(static_cast<uint8_t>(offset & 0xFF));
+			compressedData.push_back(static_cast<uint8_t>(offset >> 8));
+			if (encodedMatchLength >= 15) {
+				writeLength(encodedMatchLength - 15, compressedData);
+			}
+		}
+
+		static void writeLastLiterals(const uint8_t* literals, size_t literalLength, std::vector<uint8_t>& compressedData) {
+			compressedData.push_back(static_cast<uint8_t>(((literalLength < 15) ? literalLength : 15) << 4));
+			if (literalLength >= 15) {
+				writeLength(literalLength - 15, compressedData);
+			}
+			compressedData.insert(compressedData.end(), literals, literals + literalLength);
+		}
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <array>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+namespace NtshEngn {
+
+	// Hash map split into shards each guarded by its own reader-writer lock, readers of a shard never wait for each other and writers only block the shard they touch
+	template <typename K, typename V, typename Hash = std::hash<K>>
+	class ConcurrentHashMap {
+	public:
+		// Returns true if the key was not in the map and has been inserted
+		bool insert(const K& key, const V& value) {
+			Shard& shard = getShard(key);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+			return shard.map.insert({ key, value }).second;
+		}
+
+		void insert_or_assign(const K& key, const V& value) {
+			Shard& shard = getShard(key);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+			shard.map.insert_or_assign(key, value);
+		}
+
+		bool exist(const K& key) const {
+			const Shard& shard = getShard(key);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+			return shard.map.find(key) != shard.map.end();
+		}
+
+		// Copies the value associated to key in value, returns false if the key is not in the map
+		bool find(const K& key, V& value) const {
+			const Shard& shard = getShard(key);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+			typename std::unordered_map<K, V, Hash>::const_iterator it = shard.map.find(key);
+			if (it == shard.map.end()) {
+				return false;
+			}
+
+			value = it->second;
+
+			return true;
+		}
+
+		// Returns the value associated to key, calling create to insert it first if the key is not in the map
+		// create is called with the shard locked and must not access the map
+		V find_or_insert(const K& key, const std::function<V()>& create) {
+			Shard& shard = getShard(key);
+			{
+				std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+				typename std::unordered_map<K, V, Hash>::const_iterator it = shard.map.find(key);
+				if (it != shard.map.end()) {
+					return it->second;
+				}
+			}
+
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+			typename std::unordered_map<K, V, Hash>::const_iterator it = shard.map.find(key);
+			if (it != shard.map.end()) {
+				return it->second;
+			}
+
+			return shard.map.insert({ key, create() }).first->second;
+		}
+
+		// Returns true if the key was in the map and has been erased
+		bool erase(const K& key) {
+			Shard& shard = getShard(key);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+			return shard.map.erase(key) != 0;
+		}
+
+		void clear() {
+			for (Shard& shard : m_shards) {
+				std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+				shard.map.clear();
+			}
+		}
+
+		// Approximate when other threads are inserting or erasing
+		size_t size() const {
+			size_t size = 0;
+			for (const Shard& shard : m_shards) {
+				std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+				size += shard.map.size();
+			}
+
+			return size;
+		}
+
+		// Calls function on every element, one shard locked at a time, function must not access the map
+		void for_each(const std::function<void(const K&, const V&)>& function) const {
+			for (const Shard& shard : m_shards) {
+				std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+				for (const std::pair<const K, V>& element : shard.map) {
+					function(element.first, element.second);
+				}
+			}
+		}
+
+	private:
+		static constexpr size_t SHARD_BITS = 5;
+		static constexpr size_t SHARD_COUNT = static_cast<size_t>(1) << SHARD_BITS;
+		static constexpr size_t CACHE_LINE_SIZE = 64;
+
+		struct alignas(CACHE_LINE_SIZE) Shard {
+			mutable std::shared_mutex mutex;
+			std::unordered_map<K, V, Hash> map;
+		};
+
+		// The shard index is taken from the high bits of the mixed hash so that it does not correlate with the bucket index inside the shard
+		size_t getShardIndex(const K& key) const {
+			const uint64_t mixedHash = static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+
+			return static_cast<size_t>(mixedHash >> (64 - SHARD_BITS));
+		}
+
+		Shard& getShard(const K& key) {
+			return m_shards[getShardIndex(key)];
+		}
+
+		const Shard& getShard(const K& key) const {
+			return m_shards[getShardIndex(key)];
+		}
+
+	private:
+		std::array<Shard, SHARD_COUNT> m_shards;
+	};
+
+}
\ No newline at end of file
@@ -11,8 +11,10 @@ namespace NtshEngn {
 			if (!file.is_open()) {
 				return "";
 			}
+			std::string fileContent(static_cast<size_t>(file.tellg()), '\0');
 			file.seekg(0);
-			std::string fileContent((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			file.read(fileContent.data(), static_cast<std::streamsize>(fileContent.size()));
+			fileContent.resize(static_cast<size_t>(file.gcount()));
 			
 			return fileContent;
 		}
@@ -22,8 +24,10 @@ namespace NtshEngn {
 			if (!file.is_open()) {
 				return "";
 			}
+			std::string fileContent(static_cast<size_t>(file.tellg()), '\0');
 			file.seekg(0);
-			std::string fileContent((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			file.read(fileContent.data(), static_cast<std::streamsize>(fileContent.size()));
+			fileContent.resize(static_cast<size_t>(file.gcount()));
 			
 			return fileContent;
 		}
@@ -3,9 +3,30 @@
 #include <string>
 #include <fstream>
 #include <vector>
-#include <forward_list>
 #include <unordered_map>
-#include <variant>
+#include <unordered_set>
+#include <functional>
+#include <forward_list>
+#include <string_view>
+#include <algorithm>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <cstring>
+#include <limits>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+#if defined(NTSHENGN_COMPILER_MSVC)
+#include <intrin.h>
+#endif
 
 #if defined(NTSHENGN_DEBUG)
 #define NTSHENGN_JSON_INFO(message) \
@@ -55,237 +76,439 @@ namespace NtshEngn {
 			Null
 		};
 
+	private:
+		class Parser;
+		struct ParsedValue;
+
+	public:
+		struct Member;
+		class Writer;
+
+		// Parsed values are views, children and strings live in the JSON object that parsed them and stay valid as long as it does
+		// Constructing a string, array or object, or modifying one, gives the node its own storage, modified parsed containers first copy their children so that parsed documents are never written to
+		// As before, children added with addObject are owned by the caller and must outlive the node
 		class Node {
 		public:
+			// Construct JSON::Type::Null
+			Node() : m_type(Type::Null), m_size(0), m_integer(0) {}
+
 			// Construct JSON::Type::Object
-			Node(const std::unordered_map<std::string, Node*> children) : m_type(Type::Object), m_value(children) {}
+			Node(const std::unordered_map<std::string, Node*> children) : m_type(Type::Object), m_size(MUTABLE), m_storage(new Storage()) {
+				m_storage->members = children;
+			}
 
 			// Construct JSON::Type::Number
-			Node(float number) : m_type(Type::Number), m_value(number) {}
+			Node(double number) : m_type(Type::Number), m_size(0), m_number(number) {}
+
+			template <typename T, typename std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+			Node(T number) : m_type(Type::Number), m_size(INTEGER_NUMBER), m_integer(static_cast<int64_t>(number)) {}
 
 			// Construct JSON::Type::String
-			Node(const std::string& string) : m_type(Type::String), m_value(string) {}
+			Node(const std::string& string) : m_type(Type::String), m_size(MUTABLE), m_storage(new Storage()) {
+				m_storage->string = string;
+			}
 
 			// Construct JSON::Type::Array
-			Node(const std::vector<Node*>& array) : m_type(Type::Array), m_value(array) {}
+			Node(const std::vector<Node*>& array) : m_type(Type::Array), m_size(MUTABLE), m_storage(new Storage()) {
+				m_storage->elements = array;
+			}
 
 			// Construct JSON::Type::Boolean
-			Node(bool boolean) : m_type(Type::Boolean), m_value(boolean) {}
+			Node(bool boolean) : m_type(Type::Boolean), m_size(0), m_boolean(boolean) {}
 
-			// Construct JSON::Type::Null
-			Node() : m_type(Type::Null), m_value() {}
+			Node(const Node& other) : m_type(other.m_type), m_size(other.m_size), m_integer(other.m_integer) {
+				if (isMutable()) {
+					m_storage = copyStorage(*other.m_storage);
+				}
+			}
+
+			Node(Node&& other) noexcept : m_type(other.m_type), m_size(other.m_size), m_integer(other.m_integer) {
+				other.m_size = 0;
+			}
+
+			Node& operator=(const Node& other) {
+				if (this != &other) {
+					Node copy(other);
+					swap(copy);
+				}
+
+				return *this;
+			}
+
+			Node& operator=(Node&& other) noexcept {
+				if (this != &other) {
+					Node moved(std::move(other));
+					swap(moved);
+				}
+
+				return *this;
+			}
+
+			~Node() {
+				if (isMutable()) {
+					delete m_storage;
+				}
+			}
 
 			Type getType() const {
 				return m_type;
 			}
 
-			bool contains(const std::string& childName) const {
+			bool contains(std::string_view childName) const {
 				NTSHENGN_ASSERT(m_type == Type::Object);
 
-				const std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
+				if (isMutable()) {
+					return m_storage->members.find(std::string(childName)) != m_storage->members.end();
+				}
 
-				return (val.find(childName) != val.end());
+				return findMember(childName) != nullptr;
 			}
 
 			size_t size() const {
 				NTSHENGN_ASSERT((m_type == Type::Object) || (m_type == Type::Array));
 
-				size_t size = 0;
-				if (m_type == Type::Object) {
-					size = std::get<std::unordered_map<std::string, Node*>>(m_value).size();
-				}
-				else if (m_type == Type::Array) {
-					size = std::get<std::vector<Node*>>(m_value).size();
+				if (isMutable()) {
+					return (m_type == Type::Object) ? m_storage->members.size() : m_storage->elements.size();
 				}
 
-				return size;
+				return static_cast<size_t>(m_size);
 			}
 
 			// Access JSON::Type::Object
-			Node& operator[](const std::string& childName) {
+			Node& operator[](std::string_view childName) {
 				NTSHENGN_ASSERT(m_type == Type::Object);
 
-				const std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-				NTSHENGN_ASSERT(val.find(childName) != val.end());
+				makeMutable();
+				std::unordered_map<std::string, Node*>::const_iterator it = m_storage->members.find(std::string(childName));
+				NTSHENGN_ASSERT(it != m_storage->members.end());
 
-				return *val.at(childName);
+				return *it->second;
 			}
 
-			const Node& operator[](const std::string& childName) const {
+			const Node& operator[](std::string_view childName) const {
 				NTSHENGN_ASSERT(m_type == Type::Object);
 
-				const std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-				NTSHENGN_ASSERT(val.find(childName) != val.end());
+				if (isMutable()) {
+					std::unordered_map<std::string, Node*>::const_iterator it = m_storage->members.find(std::string(childName));
+					NTSHENGN_ASSERT(it != m_storage->members.end());
+
+					return *it->second;
+				}
+
+				const Member* member = findMember(childName);
+				NTSHENGN_ASSERT(member != nullptr);
+
+				return member->value;
+			}
+
+			// Calls function on every member, sorted by key
+			void forEachMember(const std::function<void(std::string_view, const Node&)>& function) const {
+				NTSHENGN_ASSERT(m_type == Type::Object);
 
-				return *val.at(childName);
+				if (isMutable()) {
+					for (const std::pair<const std::string, Node*>* member : getSortedMembers()) {
+						function(member->first, *member->second);
+					}
+				}
+				else {
+					for (uint32_t i = 0; i < m_size; i++) {
+						function(m_members[i].key, m_members[i].value);
+					}
+				}
 			}
 
 			// Access JSON::Type::Number
+			// Integer literals are kept as int64 and other numbers as double, each accessor converts from either
+			bool isInteger() const {
+				NTSHENGN_ASSERT(m_type == Type::Number);
+
+				return m_size == INTEGER_NUMBER;
+			}
+
 			float getNumber() const {
+				return static_cast<float>(getDouble());
+			}
+
+			double getDouble() const {
 				NTSHENGN_ASSERT(m_type == Type::Number);
 
-				const float val = std::get<float>(m_value);
+				return (m_size == INTEGER_NUMBER) ? static_cast<double>(m_integer) : m_number;
+			}
+
+			int64_t getInt() const {
+				NTSHENGN_ASSERT(m_type == Type::Number);
 
-				return val;
+				return (m_size == INTEGER_NUMBER) ? m_integer : static_cast<int64_t>(m_number);
 			}
 
 			// Access JSON::Type::String
 			std::string getString() const {
 				NTSHENGN_ASSERT(m_type == Type::String);
 
-				const std::string& val = std::get<std::string>(m_value);
+				return std::string(getStringView());
+			}
+
+			std::string_view getStringView() const {
+				NTSHENGN_ASSERT(m_type == Type::String);
+
+				if (isMutable()) {
+					return m_storage->string;
+				}
 
-				return val;
+				return std::string_view(m_string, m_size);
 			}
 
 			// Access JSON::Type::Array
 			Node& operator[](const size_t element) {
 				NTSHENGN_ASSERT(m_type == Type::Array);
 
-				const std::vector<Node*>& val = std::get<std::vector<Node*>>(m_value);
-				NTSHENGN_ASSERT(element < val.size());
+				makeMutable();
+				NTSHENGN_ASSERT(element < m_storage->elements.size());
 
-				return *val.at(element);
+				return *m_storage->elements[element];
 			}
 
 			const Node& operator[](const size_t element) const {
 				NTSHENGN_ASSERT(m_type == Type::Array);
 
-				const std::vector<Node*>& val = std::get<std::vector<Node*>>(m_value);
-				NTSHENGN_ASSERT(element < val.size());
+				if (isMutable()) {
+					NTSHENGN_ASSERT(element < m_storage->elements.size());
+
+					return *m_storage->elements[element];
+				}
+
+				NTSHENGN_ASSERT(element < m_size);
 
-				return *val.at(element);
+				return m_elements[element];
 			}
 
 			// Access JSON::Type::Boolean
 			bool getBoolean() const {
 				NTSHENGN_ASSERT(m_type == Type::Boolean);
 
-				const bool val = std::get<bool>(m_value);
-
-				return val;
+				return m_boolean;
 			}
 
 			// Add object to JSON::Type::Object
 			void addObject(const std::string& childName, Node* childNode) {
 				NTSHENGN_ASSERT((m_type == Type::Object) || (m_type == Type::Null));
 
-				std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-				NTSHENGN_ASSERT(val.find(childName) == val.end());
+				if (m_type == Type::Null) {
+					*this = Node(std::unordered_map<std::string, Node*>());
+				}
+				makeMutable();
+				NTSHENGN_ASSERT(m_storage->members.find(childName) == m_storage->members.end());
 
-				m_type = Type::Object;
-				val[childName] = childNode;
+				m_storage->members[childName] = childNode;
 			}
 
 			// Set number to JSON::Type::Number
-			void setNumber(float number) {
+			void setNumber(double number) {
 				NTSHENGN_ASSERT((m_type == Type::Number) || (m_type == Type::Null));
 
-				float& val = std::get<float>(m_value);
+				*this = Node(number);
+			}
+
+			template <typename T, typename std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+			void setNumber(T number) {
+				NTSHENGN_ASSERT((m_type == Type::Number) || (m_type == Type::Null));
 
-				m_type = Type::Number;
-				val = number;
+				*this = Node(number);
 			}
 
 			// Set string to JSON::Type::String
 			void setString(const std::string& string) {
 				NTSHENGN_ASSERT((m_type == Type::String) || (m_type == Type::Null));
 
-				std::string& val = std::get<std::string>(m_value);
-
-				m_type = Type::String;
-				val = string;
+				*this = Node(string);
 			}
 
 			// Add object to JSON::Type::Array
 			void addObject(Node* element) {
 				NTSHENGN_ASSERT((m_type == Type::Array) || (m_type == Type::Null));
 
-				std::vector<Node*>& val = std::get<std::vector<Node*>>(m_value);
+				if (m_type == Type::Null) {
+					*this = Node(std::vector<Node*>());
+				}
+				makeMutable();
 
-				m_type = Type::Array;
-				val.push_back(element);
+				m_storage->elements.push_back(element);
 			}
 
 			// Set boolean to JSON::Type::Boolean
 			void setBoolean(bool boolean) {
 				NTSHENGN_ASSERT((m_type == Type::Boolean) || (m_type == Type::Null));
-				
-				bool& val = std::get<bool>(m_value);
 
-				m_type = Type::Boolean;
-				val = boolean;
+				*this = Node(boolean);
 			}
 
+			// Pretty-printed with tabs
 			std::string to_string() const {
 				return to_string(0);
 			}
 
+			// Lines after the first are indented by indentationLevel more tabs, the first one too if indentFirst is true
 			std::string to_string(size_t indentationLevel, bool indentFirst = false) const {
-				std::string jsonString = "";
-				const std::string indentation = std::string(indentationLevel, '\t');
-
-				switch (m_type) {
-				case Type::Object: {
-					const std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-					jsonString += (indentFirst ? indentation : "") + "{\n";
-					for (std::unordered_map<std::string, Node*>::const_iterator it = val.begin(); it != val.end(); it++) {
-						jsonString += indentation + "\t\"" + it->first + "\": " + it->second->to_string(indentationLevel + 1);
-						std::unordered_map<std::string, Node*>::const_iterator tmp = it;
-						tmp++;
-						jsonString += (tmp != val.end()) ? ",\n" : "\n";
-					}
-					jsonString += indentation + "}";
-					break;
-				}
+				Writer writer(false, indentationLevel);
+				writer.value(*this);
 
-				case Type::Number: {
-					const float val = std::get<float>(m_value);
-					jsonString += (indentFirst ? indentation : "") + std::to_string(val);
-					break;
-				}
+				return (indentFirst ? std::string(indentationLevel, '\t') : "") + writer.getString();
+			}
 
-				case Type::String: {
-					const std::string& val = std::get<std::string>(m_value);
-					jsonString += (indentFirst ? indentation : "") + "\"" + val + "\"";
-					break;
+			// Without any whitespace
+			std::string to_compact_string() const {
+				Writer writer(true);
+				writer.value(*this);
+
+				return writer.getString();
+			}
+
+		private:
+			friend class Parser;
+			friend class Writer;
+
+			// Parsed nodes are only constructed once moved to the arena
+			explicit Node(const ParsedValue& value) : m_type(value.type), m_size(value.size) {
+				std::memcpy(static_cast<void*>(&m_integer), &value.integer, sizeof(m_integer));
+			}
+
+			// Storage of the strings, arrays and objects that were constructed or modified
+			struct Storage {
+				std::string string;
+				std::vector<Node*> elements;
+				std::unordered_map<std::string, Node*> members;
+
+				// Children copied from a parsed container when it was first modified, elements and members point into it
+				std::vector<Node> copiedChildren;
+
+				// Keys copied from a parsed object, they are already escaped
+				std::unordered_set<std::string> parsedKeys;
+			};
+
+			bool isMutable() const {
+				return m_size == MUTABLE;
+			}
+
+			void swap(Node& other) {
+				std::swap(m_type, other.m_type);
+				std::swap(m_size, other.m_size);
+				std::swap(m_integer, other.m_integer);
+			}
+
+			// Copies the children of a parsed container so that they can be modified
+			void makeMutable() {
+				if (isMutable()) {
+					return;
 				}
 
-				case Type::Array: {
-					const std::vector<Node*>& val = std::get<std::vector<Node*>>(m_value);
-					jsonString += (indentFirst ? indentation : "") + "[\n";
-					for (size_t i = 0; i < val.size(); i++) {
-						jsonString += val[i]->to_string(indentationLevel + 1, true);
-						jsonString += (i < (val.size() - 1)) ? ",\n" : "\n";
+				Storage* storage = new Storage();
+				storage->copiedChildren.reserve(m_size);
+				if (m_type == Type::Object) {
+					for (uint32_t i = 0; i < m_size; i++) {
+						storage->copiedChildren.push_back(m_members[i].value);
+						storage->members.insert({ std::string(m_members[i].key), &storage->copiedChildren.back() });
+						storage->parsedKeys.insert(std::string(m_members[i].key));
+					}
+				}
+				else {
+					for (uint32_t i = 0; i < m_size; i++) {
+						storage->copiedChildren.push_back(m_elements[i]);
+						storage->elements.push_back(&storage->copiedChildren.back());
 					}
-					jsonString += indentation + "]";
-					break;
 				}
+				m_size = MUTABLE;
+				m_storage = storage;
+			}
 
-				case Type::Boolean: {
-					const bool val = std::get<bool>(m_value);
-					jsonString += (indentFirst ? indentation : "") + (val ? "true" : "false");
-					break;
+			// Copied children are copied again, children added with addObject are shared
+			static Storage* copyStorage(const Storage& storage) {
+				Storage* copy = new Storage(storage);
+				const auto remap = [&storage, copy](Node*& child) {
+					const std::less<const Node*> less;
+					if (!storage.copiedChildren.empty() && !less(child, storage.copiedChildren.data()) && less(child, storage.copiedChildren.data() + storage.copiedChildren.size())) {
+						child = copy->copiedChildren.data() + (child - storage.copiedChildren.data());
+					}
+				};
+				for (Node*& element : copy->elements) {
+					remap(element);
+				}
+				for (std::pair<const std::string, Node*>& member : copy->members) {
+					remap(member.second);
 				}
 
-				case Type::Null: {
-					jsonString += (indentFirst ? indentation : "") + "null";
-					break;
+				return copy;
+			}
+
+			std::vector<const std::pair<const std::string, Node*>*> getSortedMembers() const {
+				std::vector<const std::pair<const std::string, Node*>*> members;
+				members.reserve(m_storage->members.size());
+				for (const std::pair<const std::string, Node*>& member : m_storage->members) {
+					members.push_back(&member);
 				}
+				std::sort(members.begin(), members.end(), [](const std::pair<const std::string, Node*>* a, const std::pair<const std::string, Node*>* b) {
+					return a->first < b->first;
+				});
 
-				default:
-					break;
+				return members;
+			}
+
+			const Member* findMember(std::string_view childName) const {
+				const Member* member = std::lower_bound(m_members, m_members + m_size, childName, [](const Member& member, std::string_view key) {
+					return member.key < key;
+				});
+				if ((member == (m_members + m_size)) || (member->key != childName)) {
+					return nullptr;
 				}
 
-				return jsonString;
+				return member;
 			}
 
 		private:
+			static constexpr uint32_t INTEGER_NUMBER = 1;
+			static constexpr uint32_t MUTABLE = std::numeric_limits<uint32_t>::max();
+
 			Type m_type;
-			std::variant<std::unordered_map<std::string, Node*>, float, std::string, std::vector<Node*>, bool> m_value;
+
+			// Number of children for parsed JSON::Type::Object and JSON::Type::Array, length for parsed JSON::Type::String, INTEGER_NUMBER for JSON::Type::Number stored in m_integer
+			// MUTABLE for strings, arrays and objects kept in m_storage
+			uint32_t m_size;
+
+			union {
+				int64_t m_integer;
+				double m_number;
+				bool m_boolean;
+				const char* m_string;
+				const Node* m_elements;
+				const Member* m_members;
+				Storage* m_storage;
+			};
+		};
+
+		struct Member {
+			std::string_view key;
+			Node value;
 		};
 
 	private:
+		// Values on the parser's stacks, trivially copyable so that parsing never runs the destructor of nodes owning storage
+		struct ParsedValue {
+			Type type = Type::Null;
+			uint32_t size = 0;
+			union {
+				int64_t integer = 0;
+				double number;
+				bool boolean;
+				const char* string;
+				const Node* elements;
+				const Member* members;
+			};
+		};
+
+		struct ParsedMember {
+			std::string_view key;
+			ParsedValue value;
+		};
+
 		enum class TokenType {
 			CurlyBracketOpen,
 			CurlyBracketClose,
@@ -297,319 +520,641 @@ namespace NtshEngn {
 			ArrayBracketClose,
 			Boolean,
 			Null,
-			EndOfFile
+			EndOfFile,
+			Incomplete
 		};
 
 		struct Token {
 			TokenType type;
-			std::string value = "";
+			std::string_view value;
 		};
 
+		// Tokenizes a contiguous character buffer in a single pass, token values are views into that buffer
+		// When the buffer is not the end of the input, a token cut by the end of the buffer is returned as TokenType::Incomplete and the lexer rewinds to its beginning
 		class Lexer {
 		public:
-			~Lexer() {
-				if (m_file.is_open()) {
-					m_file.close();
-				}
+			void setBuffer(const char* begin, const char* end, bool endOfInput = true) {
+				m_begin = begin;
+				m_current = begin;
+				m_end = end;
+				m_endOfInput = endOfInput;
+				m_structuralIndexCurrent = nullptr;
+				m_structuralIndexEnd = nullptr;
 			}
 
-			void open(const std::string& filePath) {
-				m_file.open(filePath, std::fstream::in | std::fstream::binary);
-				if (!m_file.is_open()) {
-					NTSHENGN_JSON_ERROR("Cannot open JSON file \"" + filePath + "\".", Result::JSONError);
-				}
+			// Tokens are then read at the offsets of the structural index instead of being searched for, a string's closing quote is the entry following its opening quote
+			void setStructuralIndex(const std::vector<uint32_t>& structuralIndex) {
+				m_structuralIndexCurrent = structuralIndex.data();
+				m_structuralIndexEnd = structuralIndex.data() + structuralIndex.size();
 			}
 
-			char nextCharacter() {
-				char c = ' ';
-				while ((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t')) {
-					m_file.get(c);
-
-					if (((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t')) && m_file.eof()) {
-						return '\0';
-					}
-				}
-
-				return c;
+			const char* getPosition() const {
+				return m_current;
 			}
 
 			Token getNextToken() {
 				Token token;
 
-				char c;
+				if (m_structuralIndexCurrent) {
+					if (m_structuralIndexCurrent == m_structuralIndexEnd) {
+						token.type = TokenType::EndOfFile;
 
-				if (m_file.eof()) {
-					NTSHENGN_JSON_ERROR("Reached end-of-file early.", Result::JSONError);
+						return token;
+					}
+					m_current = m_begin + *m_structuralIndexCurrent++;
+				}
+				else {
+					skipWhitespaces();
+					if (m_current == m_end) {
+						token.type = m_endOfInput ? TokenType::EndOfFile : TokenType::Incomplete;
+
+						return token;
+					}
 				}
 
-				m_previousPosition = m_file.tellg();
-				c = nextCharacter();
-				if (c == '"') {
+				const char* tokenBegin = m_current;
+				const char c = *m_current++;
+				switch (c) {
+				case '"': {
 					token.type = TokenType::String;
-					token.value = "";
 
-					m_file.get(c);
-					while (c != '\"') {
-						token.value += c;
+					const char* stringBegin = m_current;
+					if (m_structuralIndexCurrent) {
+						if (m_structuralIndexCurrent == m_structuralIndexEnd) {
+							NTSHENGN_JSON_ERROR("Reached end-of-file while parsing a string.", Result::JSONError);
+						}
+						m_current = m_begin + *m_structuralIndexCurrent++;
+					}
+					while ((m_current != m_end) && (*m_current != '"')) {
+						if (*m_current == '\\') {
+							m_current++;
+							if (m_current == m_end) {
+								break;
+							}
+						}
+						m_current++;
+					}
+					if (m_current == m_end) {
+						if (!m_endOfInput) {
+							return incomplete(tokenBegin);
+						}
 
-						m_file.get(c);
+						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing a string.", Result::JSONError);
 					}
+					token.value = std::string_view(stringBegin, static_cast<size_t>(m_current - stringBegin));
+					m_current++;
+					break;
 				}
-				else if (c == '{') {
+
+				case '{':
 					token.type = TokenType::CurlyBracketOpen;
-				}
-				else if (c == '}') {
+					break;
+
+				case '}':
 					token.type = TokenType::CurlyBracketClose;
-				}
-				else if (c == '[') {
+					break;
+
+				case '[':
 					token.type = TokenType::ArrayBracketOpen;
-				}
-				else if (c == ']') {
+					break;
+
+				case ']':
 					token.type = TokenType::ArrayBracketClose;
-				}
-				else if (c == ':') {
-					token.type = TokenType::Colon;
-				}
-				else if (c == ',') {
-					token.type = TokenType::Comma;
-				}
-				else if (c == '-' || ((c >= '0') && (c <= '9'))) {
-					token.type = TokenType::Number;
-					token.value += c;
+					break;
 
-					size_t previousCharPosition;
-					while ((c == '-') || (c == '.') || (c == 'e') || ((c >= '0') && (c <= '9'))) {
-						previousCharPosition = m_file.tellg();
-						m_file.get(c);
+				case ':':
+					token.type = TokenType::Colon;
+					break;
 
-						if (m_file.eof()) {
-							break;
-						}
+				case ',':
+					token.type = TokenType::Comma;
+					break;
 
-						if ((c == '-') || (c == '.') || (c == 'e') || ((c >= '0') && (c <= '9'))) {
-							token.value += c;
-						}
-						else {
-							m_file.seekg(previousCharPosition);
-							break;
-						}
-					}
-				}
-				else if (c == 't') {
+				case 't':
 					token.type = TokenType::Boolean;
-					token.value = "t";
+					if (!readLiteral(tokenBegin, "true", token.value)) {
+						return incomplete(tokenBegin);
+					}
+					break;
 
-					m_file.get(c);
-					token.value += c;
+				case 'f':
+					token.type = TokenType::Boolean;
+					if (!readLiteral(tokenBegin, "false", token.value)) {
+						return incomplete(tokenBegin);
+					}
+					break;
 
-					if (c == 'r') {
-						m_file.get(c);
-						token.value += c;
+				case 'n':
+					token.type = TokenType::Null;
+					if (!readLiteral(tokenBegin, "null", token.value)) {
+						return incomplete(tokenBegin);
+					}
+					break;
 
-						if (c == 'u') {
-							m_file.get(c);
-							token.value += c;
+				default:
+					if ((c == '-') || ((c >= '0') && (c <= '9'))) {
+						token.type = TokenType::Number;
 
-							if (c != 'e') {
-								NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.", Result::JSONError);
-							}
+						while ((m_current != m_end) && isNumberCharacter(*m_current)) {
+							m_current++;
 						}
-						else {
-							NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.", Result::JSONError);
+						if ((m_current == m_end) && !m_endOfInput) {
+							return incomplete(tokenBegin);
 						}
+						token.value = std::string_view(tokenBegin, static_cast<size_t>(m_current - tokenBegin));
 					}
 					else {
-						NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.", Result::JSONError);
+						NTSHENGN_JSON_ERROR("Reached an unknown token (\"" + std::string(1, c) + "\").", Result::JSONError);
 					}
+					break;
 				}
-				else if (c == 'f') {
-					token.type = TokenType::Boolean;
-					token.value = "f";
-
-					m_file.get(c);
-					token.value += c;
 
-					if (c == 'a') {
-						m_file.get(c);
-						token.value += c;
-
-						if (c == 'l') {
-							m_file.get(c);
-							token.value += c;
-
-							if (c == 's') {
-								m_file.get(c);
-								token.value += c;
+				return token;
+			}
 
-								if (c != 'e') {
-									NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.", Result::JSONError);
-								}
-							}
-							else {
-								NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.", Result::JSONError);
-							}
-						}
-						else {
-							NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.", Result::JSONError);
-						}
-					}
-					else {
-						NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.", Result::JSONError);
-					}
+		private:
+			void skipWhitespaces() {
+				while ((m_current != m_end) && ((*m_current == ' ') || (*m_current == '\n') || (*m_current == '\r') || (*m_current == '\t'))) {
+					m_current++;
 				}
-				else if (c == 'n') {
-					token.type = TokenType::Null;
-					std::string nullValue = "n";
-
-					m_file.get(c);
-					nullValue += c;
-					if (c == 'u') {
-						m_file.get(c);
-						nullValue += c;
+			}
 
-						if (c == 'l') {
-							m_file.get(c);
-							nullValue += c;
+			static bool isNumberCharacter(char c) {
+				return ((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == '.') || (c == 'e') || (c == 'E');
+			}
 
-							if (c != 'l') {
-								NTSHENGN_JSON_ERROR("\"" + nullValue + "\" token is invalid.", Result::JSONError);
-							}
-						}
-						else {
-							NTSHENGN_JSON_ERROR("\"" + nullValue + "\" token is invalid.", Result::JSONError);
-						}
-					}
-					else {
-						NTSHENGN_JSON_ERROR("\"" + nullValue + "\" token is invalid.", Result::JSONError);
-					}
-				}
-				else if (c == '\0') {
-					token.type = TokenType::EndOfFile;
+			// Returns false if the literal is cut by the end of a buffer that is not the end of the input
+			bool readLiteral(const char* literalBegin, std::string_view literal, std::string_view& value) {
+				const size_t availableSize = static_cast<size_t>(m_end - literalBegin);
+				if ((availableSize < literal.size()) && !m_endOfInput && (std::string_view(literalBegin, availableSize) == literal.substr(0, availableSize))) {
+					return false;
 				}
-				else {
-					NTSHENGN_JSON_ERROR("Reached an unknown token (\"" + std::string() + c + "\").", Result::JSONError);
+				if ((availableSize < literal.size()) || (std::string_view(literalBegin, literal.size()) != literal)) {
+					NTSHENGN_JSON_ERROR("\"" + std::string(literalBegin, std::min(availableSize, literal.size())) + "\" token is invalid.", Result::JSONError);
 				}
+				m_current = literalBegin + literal.size();
+				value = std::string_view(literalBegin, literal.size());
 
-				return token;
+				return true;
 			}
 
-			bool endOfFile() {
-				return m_file.eof();
+			Token incomplete(const char* tokenBegin) {
+				m_current = tokenBegin;
+
+				Token token;
+				token.type = TokenType::Incomplete;
+
+				return token;
 			}
 
 		private:
-			std::fstream m_file;
-			size_t m_previousPosition;
+			const char* m_begin = nullptr;
+			const char* m_current = nullptr;
+			const char* m_end = nullptr;
+			bool m_endOfInput = true;
+
+			const uint32_t* m_structuralIndexCurrent = nullptr;
+			const uint32_t* m_structuralIndexEnd = nullptr;
 		};
 
-		class Parser {
+		// Finds the offset of every token start (structural characters, quotes and first characters of numbers and literals) outside of strings in a single pass over 64-byte blocks
+		// Characters are classified with AVX2, SSE2 or NEON when available, then strings are masked out with bit operations, as in simdjson's first stage
+		class StructuralIndexer {
 		public:
-			Node parse(const std::string& filePath) {
-				m_lexer.open(filePath);
-				
-				Node root;
-				bool rootInitialized = false;
-
-				while (!m_lexer.endOfFile()) {
-					Token token = m_lexer.getNextToken();
-					Node node;
-					switch (token.type) {
-					case TokenType::CurlyBracketOpen: {
-						node = parseObject();
-						break;
-					}
-
-					case TokenType::String: {
-						node = Node(token.value);
-						break;
-					}
-
-					case TokenType::Number: {
-						node = Node(std::stof(token.value));
-						break;
+			static void build(const char* data, size_t size, std::vector<uint32_t>& structuralIndex) {
+				structuralIndex.clear();
+				structuralIndex.reserve(size / 4);
+
+				uint64_t previousInString = 0;
+				uint64_t previousEndsWithSeparator = 1;
+				bool escapeNext = false;
+
+				for (size_t blockOffset = 0; blockOffset < size; blockOffset += 64) {
+					const size_t blockSize = std::min<size_t>(64, size - blockOffset);
+					const char* block = data + blockOffset;
+
+					// Pad the last block with whitespaces
+					char paddedBlock[64];
+					if (blockSize < 64) {
+						std::memset(paddedBlock, ' ', 64);
+						std::memcpy(paddedBlock, block, blockSize);
+						block = paddedBlock;
 					}
 
-					case TokenType::ArrayBracketOpen: {
-						node = parseArray();
-						break;
-					}
+					const BlockMasks masks = classify(block);
 
-					case TokenType::Boolean: {
-						node = Node(token.value == "true");
-						break;
+					// Characters following an odd number of backslashes are escaped, backslashes are rare so this is done bit by bit
+					uint64_t escaped = 0;
+					if ((masks.backslash != 0) || escapeNext) {
+						for (uint32_t i = 0; i < 64; i++) {
+							const uint64_t bit = static_cast<uint64_t>(1) << i;
+							if (escapeNext) {
+								escaped |= bit;
+								escapeNext = false;
+							}
+							else if (masks.backslash & bit) {
+								escapeNext = true;
+							}
+						}
 					}
 
-					default:
-						break;
-					}
+					// Every character from an opening quote to the character before its closing quote is in a string
+					const uint64_t quotes = masks.quote & ~escaped;
+					const uint64_t inString = prefixXor(quotes) ^ previousInString;
+					previousInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
 
-					if (!rootInitialized) {
-						root = node;
+					const uint64_t structurals = masks.structural & ~inString;
+					const uint64_t separators = structurals | (masks.whitespace & ~inString);
+					const uint64_t scalarStarts = ~(separators | quotes | inString) & ((separators << 1) | previousEndsWithSeparator);
+					previousEndsWithSeparator = separators >> 63;
 
-						rootInitialized = true;
+					uint64_t tokens = structurals | quotes | scalarStarts;
+					while (tokens != 0) {
+						structuralIndex.push_back(static_cast<uint32_t>(blockOffset + countTrailingZeros(tokens)));
+						tokens &= tokens - 1;
 					}
 				}
-
-				return root;
 			}
 
 		private:
-			Node parseObject() {
-				Node objectNode = Node(std::unordered_map<std::string, Node*>());
-
-				bool endOfObject = false;
-				while (!endOfObject) {
-					// Map key
-					Token keyToken = m_lexer.getNextToken();
-
-					// Empty object
-					if (keyToken.type == TokenType::CurlyBracketClose) {
-						return objectNode;
-					}
-
-					// Colon
-					if (m_lexer.getNextToken().type != TokenType::Colon) {
-						NTSHENGN_JSON_ERROR("An object key (\"" + keyToken.value + "\") is not followed by a colon.", Result::JSONError);
-					}
-
-					Token token = m_lexer.getNextToken();
-					Node node;
-					switch (token.type) {
-					case TokenType::CurlyBracketOpen: {
-						node = parseObject();
+			struct BlockMasks {
+				uint64_t quote = 0;
+				uint64_t backslash = 0;
+				uint64_t whitespace = 0;
+				uint64_t structural = 0;
+			};
+
+			static BlockMasks classify(const char* block) {
+				BlockMasks masks;
+
+#if defined(__AVX2__)
+				for (uint32_t i = 0; i < 2; i++) {
+					const __m256i characters = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + (i * 32)));
+					const auto equals = [&characters](char c) {
+						return _mm256_cmpeq_epi8(characters, _mm256_set1_epi8(c));
+					};
+					const auto toMask = [](__m256i comparison) {
+						return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(comparison)));
+					};
+
+					masks.quote |= toMask(equals('"')) << (i * 32);
+					masks.backslash |= toMask(equals('\\')) << (i * 32);
+					masks.whitespace |= toMask(_mm256_or_si256(_mm256_or_si256(equals(' '), equals('\t')), _mm256_or_si256(equals('\n'), equals('\r')))) << (i * 32);
+					masks.structural |= toMask(_mm256_or_si256(_mm256_or_si256(_mm256_or_si256(equals('{'), equals('}')), _mm256_or_si256(equals('['), equals(']'))), _mm256_or_si256(equals(':'), equals(',')))) << (i * 32);
+				}
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+				for (uint32_t i = 0; i < 4; i++) {
+					const __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + (i * 16)));
+					const auto equals = [&characters](char c) {
+						return _mm_cmpeq_epi8(characters, _mm_set1_epi8(c));
+					};
+					const auto toMask = [](__m128i comparison) {
+						return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(comparison)));
+					};
+
+					masks.quote |= toMask(equals('"')) << (i * 16);
+					masks.backslash |= toMask(equals('\\')) << (i * 16);
+					masks.whitespace |= toMask(_mm_or_si128(_mm_or_si128(equals(' '), equals('\t')), _mm_or_si128(equals('\n'), equals('\r')))) << (i * 16);
+					masks.structural |= toMask(_mm_or_si128(_mm_or_si128(_mm_or_si128(equals('{'), equals('}')), _mm_or_si128(equals('['), equals(']'))), _mm_or_si128(equals(':'), equals(',')))) << (i * 16);
+				}
+#elif defined(__aarch64__) || defined(_M_ARM64)
+				static const uint8_t bitWeights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+				const uint8x16_t weights = vld1q_u8(bitWeights);
+				for (uint32_t i = 0; i < 4; i++) {
+					const uint8x16_t characters = vld1q_u8(reinterpret_cast<const uint8_t*>(block + (i * 16)));
+					const auto equals = [&characters](char c) {
+						return vceqq_u8(characters, vdupq_n_u8(static_cast<uint8_t>(c)));
+					};
+					const auto toMask = [&weights](uint8x16_t comparison) {
+						const uint8x16_t weighted = vandq_u8(comparison, weights);
+
+						return static_cast<uint64_t>(vaddv_u8(vget_low_u8(weighted))) | (static_cast<uint64_t>(vaddv_u8(vget_high_u8(weighted))) << 8);
+					};
+
+					masks.quote |= toMask(equals('"')) << (i * 16);
+					masks.backslash |= toMask(equals('\\')) << (i * 16);
+					masks.whitespace |= toMask(vorrq_u8(vorrq_u8(equals(' '), equals('\t')), vorrq_u8(equals('\n'), equals('\r')))) << (i * 16);
+					masks.structural |= toMask(vorrq_u8(vorrq_u8(vorrq_u8(equals('{'), equals('}')), vorrq_u8(equals('['), equals(']'))), vorrq_u8(equals(':'), equals(',')))) << (i * 16);
+				}
+#else
+				for (uint32_t i = 0; i < 64; i++) {
+					const uint64_t bit = static_cast<uint64_t>(1) << i;
+					switch (block[i]) {
+					case '"':
+						masks.quote |= bit;
 						break;
-					}
 
-					case TokenType::String: {
-						node = Node(token.value);
+					case '\\':
+						masks.backslash |= bit;
 						break;
-					}
 
-					case TokenType::Number: {
-						node = Node(std::stof(token.value));
+					case ' ':
+					case '\t':
+					case '\n':
+					case '\r':
+						masks.whitespace |= bit;
 						break;
-					}
 
-					case TokenType::ArrayBracketOpen: {
-						node = parseArray();
+					case '{':
+					case '}':
+					case '[':
+					case ']':
+					case ':':
+					case ',':
+						masks.structural |= bit;
 						break;
-					}
 
-					case TokenType::Boolean: {
-						node = Node(token.value == "true");
+					default:
 						break;
 					}
+				}
+#endif
 
-					case TokenType::EndOfFile: {
-						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing an object.", Result::JSONError);
-					}
+				return masks;
+			}
 
-					default:
+			// Bit i of the result is the xor of bits 0 to i
+			static uint64_t prefixXor(uint64_t bits) {
+				bits ^= bits << 1;
+				bits ^= bits << 2;
+				bits ^= bits << 4;
+				bits ^= bits << 8;
+				bits ^= bits << 16;
+				bits ^= bits << 32;
+
+				return bits;
+			}
+
+			static uint32_t countTrailingZeros(uint64_t bits) {
+#if defined(NTSHENGN_COMPILER_MSVC)
+				unsigned long index;
+				_BitScanForward64(&index, bits);
+
+				return static_cast<uint32_t>(index);
+#elif defined(NTSHENGN_COMPILER_GCC) || defined(NTSHENGN_COMPILER_CLANG)
+				return static_cast<uint32_t>(__builtin_ctzll(bits));
+#else
+				uint32_t count = 0;
+				while ((bits & 1) == 0) {
+					bits >>= 1;
+					count++;
+				}
+
+				return count;
+#endif
+			}
+		};
+
+		// Parses a number token made only of an optional minus sign and digits, returns false if it is not one or does not fit in an int64
+		static bool parseInteger(std::string_view number, int64_t& value) {
+			const char* current = number.data();
+			const char* end = number.data() + number.size();
+
+			const bool negative = (current != end) && (*current == '-');
+			if (negative) {
+				current++;
+			}
+			if ((current == end) || ((end - current) > 19)) {
+				return false;
+			}
+
+			uint64_t magnitude = 0;
+			while (current != end) {
+				const uint64_t digit = static_cast<uint64_t>(*current - '0');
+				if (digit > 9) {
+					return false;
+				}
+				magnitude = (magnitude * 10) + digit;
+				current++;
+			}
+
+			const uint64_t maxMagnitude = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+			if (magnitude > maxMagnitude) {
+				return false;
+			}
+
+			value = negative ? static_cast<int64_t>(~magnitude + 1) : static_cast<int64_t>(magnitude);
+
+			return true;
+		}
+
+		// Parses a number token, which is not null-terminated when it ends a buffer
+		// Numbers with up to 19 significant digits and a power of ten up to 22 are exactly represented by their mantissa and power of ten as doubles (Clinger's fast path), others go through strtod
+		static double parseNumber(std::string_view number) {
+			static const double powersOfTen[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+			const char* current = number.data();
+			const char* end = number.data() + number.size();
+
+			const bool negative = (current != end) && (*current == '-');
+			if (negative) {
+				current++;
+			}
+
+			uint64_t mantissa = 0;
+			int32_t significantDigitCount = 0;
+			int32_t exponent = 0;
+			bool truncated = false;
+			const auto readDigit = [&](bool fractional) {
+				const uint64_t digit = static_cast<uint64_t>(*current - '0');
+				if ((mantissa == 0) && (digit == 0)) {
+					if (fractional) {
+						exponent--;
+					}
+				}
+				else if (significantDigitCount < 19) {
+					mantissa = (mantissa * 10) + digit;
+					significantDigitCount++;
+					if (fractional) {
+						exponent--;
+					}
+				}
+				else {
+					truncated = true;
+					if (!fractional) {
+						exponent++;
+					}
+				}
+				current++;
+			};
+
+			while ((current != end) && (*current >= '0') && (*current <= '9')) {
+				readDigit(false);
+			}
+			if ((current != end) && (*current == '.')) {
+				current++;
+				while ((current != end) && (*current >= '0') && (*current <= '9')) {
+					readDigit(true);
+				}
+			}
+			if ((current != end) && ((*current == 'e') || (*current == 'E'))) {
+				current++;
+				const bool negativeExponent = (current != end) && (*current == '-');
+				if ((current != end) && ((*current == '-') || (*current == '+'))) {
+					current++;
+				}
+				int32_t explicitExponent = 0;
+				while ((current != end) && (*current >= '0') && (*current <= '9')) {
+					if (explicitExponent < 100000) {
+						explicitExponent = (explicitExponent * 10) + (*current - '0');
+					}
+					current++;
+				}
+				exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			}
+
+			if ((current == end) && !truncated && (mantissa <= (static_cast<uint64_t>(1) << 53)) && (exponent >= -22) && (exponent <= 22)) {
+				double value = static_cast<double>(mantissa);
+				value = (exponent < 0) ? (value / powersOfTen[-exponent]) : (value * powersOfTen[exponent]);
+
+				return negative ? -value : value;
+			}
+
+			// Literals too long for the buffer, with many digits, are null-terminated in a string instead of being truncated
+			char numberString[64];
+			if (number.size() >= sizeof(numberString)) {
+				return std::strtod(std::string(number).c_str(), nullptr);
+			}
+			std::copy(number.begin(), number.end(), numberString);
+			numberString[number.size()] = '\0';
+
+			return std::strtod(numberString, nullptr);
+		}
+
+		// Bump allocator handing out contiguous arrays from a few large blocks, values are never destroyed so they must not own anything, as parsed nodes do not
+		class Arena {
+		public:
+			template <typename T>
+			T* allocate(size_t count) {
+				const size_t size = count * sizeof(T);
+				size_t offset = (m_blockOffset + alignof(T) - 1) & ~(alignof(T) - 1);
+				if (m_blocks.empty() || ((offset + size) > m_blockSize)) {
+					m_blockSize = std::max(std::min(m_blockSize * 2, MAX_BLOCK_SIZE), size);
+					m_blocks.emplace_back(new std::byte[m_blockSize]);
+					offset = 0;
+				}
+				m_blockOffset = offset + size;
+
+				return reinterpret_cast<T*>(m_blocks.back().get() + offset);
+			}
+
+		private:
+			static constexpr size_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+			std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+			size_t m_blockSize = 32 * 1024;
+			size_t m_blockOffset = 0;
+		};
+
+		// Children are accumulated on a stack while their container is parsed, then moved into the arena in one contiguous array
+		class Parser {
+		public:
+			Node parseFile(const std::string& filePath) {
+				std::ifstream file(filePath, std::ios::in | std::ios::binary | std::ios::ate);
+				if (!file.is_open()) {
+					NTSHENGN_JSON_ERROR("Cannot open JSON file \"" + filePath + "\".", Result::JSONError);
+				}
+
+				// Read the whole file in one call, the lexer then works on the buffer
+				const std::streamsize fileSize = file.tellg();
+				m_buffers.emplace_front(static_cast<size_t>(std::max<std::streamsize>(fileSize, 0)), '\0');
+				file.seekg(0);
+				file.read(m_buffers.front().data(), fileSize);
+
+				return parseBuffer();
+			}
+
+			Node parseString(std::string_view jsonString) {
+				m_buffers.emplace_front(jsonString);
+
+				return parseBuffer();
+			}
+
+		private:
+			Node parseBuffer() {
+				const std::string& buffer = m_buffers.front();
+				m_lexer.setBuffer(buffer.data(), buffer.data() + buffer.size());
+				if (buffer.size() <= std::numeric_limits<uint32_t>::max()) {
+					StructuralIndexer::build(buffer.data(), buffer.size(), m_structuralIndex);
+					m_lexer.setStructuralIndex(m_structuralIndex);
+				}
+
+				Token token = m_lexer.getNextToken();
+				if (token.type == TokenType::EndOfFile) {
+					return Node();
+				}
+
+				return Node(parseValue(token));
+			}
+
+			ParsedValue parseValue(const Token& token) {
+				ParsedValue value;
+				switch (token.type) {
+				case TokenType::CurlyBracketOpen:
+					return parseObject();
+
+				case TokenType::String:
+					value.type = Type::String;
+					value.size = static_cast<uint32_t>(token.value.size());
+					value.string = token.value.data();
+					break;
+
+				case TokenType::Number:
+					value.type = Type::Number;
+					if (parseInteger(token.value, value.integer)) {
+						value.size = Node::INTEGER_NUMBER;
+					}
+					else {
+						value.number = parseNumber(token.value);
+					}
+					break;
+
+				case TokenType::ArrayBracketOpen:
+					return parseArray();
+
+				case TokenType::Boolean:
+					value.type = Type::Boolean;
+					value.boolean = token.value == "true";
+					break;
+
+				case TokenType::EndOfFile:
+					NTSHENGN_JSON_ERROR("Reached end-of-file early.", Result::JSONError);
+
+				default:
+					break;
+				}
+
+				return value;
+			}
+
+			ParsedValue parseObject() {
+				const size_t stackBegin = m_memberStack.size();
+
+				bool endOfObject = false;
+				while (!endOfObject) {
+					// Map key
+					Token keyToken = m_lexer.getNextToken();
+
+					// Empty object
+					if ((keyToken.type == TokenType::CurlyBracketClose) && (m_memberStack.size() == stackBegin)) {
 						break;
 					}
 
-					m_nodes.push_front(node);
-					objectNode.addObject(keyToken.value, &m_nodes.front());
+					if (keyToken.type != TokenType::String) {
+						NTSHENGN_JSON_ERROR("An object key is not a string.", Result::JSONError);
+					}
+
+					// Colon
+					if (m_lexer.getNextToken().type != TokenType::Colon) {
+						NTSHENGN_JSON_ERROR("An object key (\"" + std::string(keyToken.value) + "\") is not followed by a colon.", Result::JSONError);
+					}
+
+					Token token = m_lexer.getNextToken();
+					if (token.type == TokenType::EndOfFile) {
+						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing an object.", Result::JSONError);
+					}
+
+					m_memberStack.push_back({ keyToken.value, parseValue(token) });
 
 					// Next token is either a comma or a curly bracket close
 					if (m_lexer.getNextToken().type == TokenType::CurlyBracketClose) {
@@ -617,71 +1162,674 @@ namespace NtshEngn {
 					}
 				}
 
-				return objectNode;
+				// Sort keys so that lookups are a binary search, stable to keep the first of duplicated keys first
+				std::stable_sort(m_memberStack.begin() + stackBegin, m_memberStack.end(), [](const ParsedMember& a, const ParsedMember& b) {
+					return a.key < b.key;
+				});
+
+				ParsedValue objectValue;
+				objectValue.type = Type::Object;
+				objectValue.size = static_cast<uint32_t>(m_memberStack.size() - stackBegin);
+				objectValue.members = nullptr;
+				if (objectValue.size != 0) {
+					Member* members = m_arena.allocate<Member>(objectValue.size);
+					for (uint32_t i = 0; i < objectValue.size; i++) {
+						const ParsedMember& member = m_memberStack[stackBegin + i];
+						new (members + i) Member{ member.key, Node(member.value) };
+					}
+					m_memberStack.resize(stackBegin);
+					objectValue.members = members;
+				}
+
+				return objectValue;
 			}
 
-			Node parseArray() {
-				Node arrayNode = Node(std::vector<Node*>());
+			ParsedValue parseArray() {
+				const size_t stackBegin = m_elementStack.size();
 
 				bool endOfArray = false;
 				while (!endOfArray) {
 					Token token = m_lexer.getNextToken();
-					Node node;
-					switch (token.type) {
-					case TokenType::CurlyBracketOpen: {
-						node = parseObject();
+
+					// Empty array
+					if ((token.type == TokenType::ArrayBracketClose) && (m_elementStack.size() == stackBegin)) {
 						break;
 					}
 
-					case TokenType::String: {
-						node = Node(token.value);
-						break;
+					if (token.type == TokenType::EndOfFile) {
+						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing an array.", Result::JSONError);
 					}
 
-					case TokenType::Number: {
-						node = Node(std::stof(token.value));
-						break;
+					m_elementStack.push_back(parseValue(token));
+
+					// Next token is either a comma or an array bracket close
+					if (m_lexer.getNextToken().type == TokenType::ArrayBracketClose) {
+						endOfArray = true;
 					}
+				}
 
-					case TokenType::ArrayBracketOpen: {
-						node = parseArray();
-						break;
+				ParsedValue arrayValue;
+				arrayValue.type = Type::Array;
+				arrayValue.size = static_cast<uint32_t>(m_elementStack.size() - stackBegin);
+				arrayValue.elements = nullptr;
+				if (arrayValue.size != 0) {
+					Node* elements = m_arena.allocate<Node>(arrayValue.size);
+					for (uint32_t i = 0; i < arrayValue.size; i++) {
+						new (elements + i) Node(m_elementStack[stackBegin + i]);
 					}
+					m_elementStack.resize(stackBegin);
+					arrayValue.elements = elements;
+				}
 
-					case TokenType::Boolean: {
-						node = Node(token.value == "true");
-						break;
+				return arrayValue;
+			}
+
+		private:
+			// Strings in the parsed nodes point into these buffers, one per parsed document
+			std::forward_list<std::string> m_buffers;
+			Lexer m_lexer;
+
+			std::vector<uint32_t> m_structuralIndex;
+
+			Arena m_arena;
+			std::vector<ParsedValue> m_elementStack;
+			std::vector<ParsedMember> m_memberStack;
+		};
+
+	public:
+		// Streaming reader producing one event per call to next() without building nodes, files are read in fixed-size chunks so memory does not grow with the file size
+		class Reader {
+		public:
+			enum class Event {
+				ObjectStart,
+				ObjectEnd,
+				ArrayStart,
+				ArrayEnd,
+				Key,
+				Number,
+				String,
+				Boolean,
+				Null,
+				EndOfDocument
+			};
+
+			// Returns false if the file could not be opened
+			bool open(const std::string& filePath) {
+				m_file.open(filePath, std::ios::in | std::ios::binary);
+				if (!m_file.is_open()) {
+					return false;
+				}
+
+				m_buffer.resize(CHUNK_SIZE);
+				m_bufferSize = 0;
+				m_containers.clear();
+				m_lexer.setBuffer(m_buffer.data(), m_buffer.data(), false);
+
+				return true;
+			}
+
+			// jsonString must stay valid while it is being read
+			void openString(std::string_view jsonString) {
+				m_containers.clear();
+				m_lexer.setBuffer(jsonString.data(), jsonString.data() + jsonString.size());
+			}
+
+			Event next() {
+				Token token = getNextToken();
+
+				// Commas only separate values, the next key or element follows
+				if (token.type == TokenType::Comma) {
+					m_expectKey = !m_containers.empty() && m_containers.back();
+					token = getNextToken();
+				}
+
+				switch (token.type) {
+				case TokenType::CurlyBracketOpen:
+					m_containers.push_back(true);
+					m_expectKey = true;
+					return Event::ObjectStart;
+
+				case TokenType::CurlyBracketClose:
+					popContainer();
+					return Event::ObjectEnd;
+
+				case TokenType::ArrayBracketOpen:
+					m_containers.push_back(false);
+					m_expectKey = false;
+					return Event::ArrayStart;
+
+				case TokenType::ArrayBracketClose:
+					popContainer();
+					return Event::ArrayEnd;
+
+				case TokenType::String:
+					m_value = token.value;
+					if (m_expectKey) {
+						m_expectKey = false;
+						if (getNextToken().type != TokenType::Colon) {
+							NTSHENGN_JSON_ERROR("An object key (\"" + std::string(token.value) + "\") is not followed by a colon.", Result::JSONError);
+						}
+
+						return Event::Key;
 					}
+					return Event::String;
 
-					case TokenType::EndOfFile: {
-						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing an array.", Result::JSONError);
+				case TokenType::Number:
+					m_value = token.value;
+					return Event::Number;
+
+				case TokenType::Boolean:
+					m_value = token.value;
+					return Event::Boolean;
+
+				case TokenType::Null:
+					return Event::Null;
+
+				case TokenType::EndOfFile:
+					return Event::EndOfDocument;
+
+				default:
+					NTSHENGN_JSON_ERROR("Unexpected token.", Result::JSONError);
+				}
+			}
+
+			// Key of the last Event::Key or value of the last Event::String, valid until the next call to next()
+			std::string_view getString() const {
+				return m_value;
+			}
+
+			// Value of the last Event::Number
+			double getNumber() const {
+				return parseNumber(m_value);
+			}
+
+			// Value of the last Event::Number, exact for integers that do not fit in a double
+			int64_t getInt() const {
+				int64_t integer;
+				if (parseInteger(m_value, integer)) {
+					return integer;
+				}
+
+				return static_cast<int64_t>(parseNumber(m_value));
+			}
+
+			// Value of the last Event::Boolean
+			bool getBoolean() const {
+				return m_value == "true";
+			}
+
+			// Reads the next value, returns 0 if it is not a number
+			double readNumber() {
+				const Event event = next();
+				if (event != Event::Number) {
+					skipValue(event);
+
+					return 0.0;
+				}
+
+				return getNumber();
+			}
+
+			// Reads the next value, returns 0 if it is not a number
+			int64_t readInt() {
+				const Event event = next();
+				if (event != Event::Number) {
+					skipValue(event);
+
+					return 0;
+				}
+
+				return getInt();
+			}
+
+			// Reads the next value, returns an empty string if it is not a string
+			std::string readString() {
+				const Event event = next();
+				if (event != Event::String) {
+					skipValue(event);
+
+					return "";
+				}
+
+				return std::string(getString());
+			}
+
+			// Skips the next value, after an Event::Key or inside an array
+			void skipValue() {
+				skipValue(next());
+			}
+
+			// Skips the rest of the value that started with event
+			void skipValue(Event event) {
+				if ((event != Event::ObjectStart) && (event != Event::ArrayStart)) {
+					return;
+				}
+
+				size_t depth = 1;
+				while (depth != 0) {
+					const Event nestedEvent = next();
+					if ((nestedEvent == Event::ObjectStart) || (nestedEvent == Event::ArrayStart)) {
+						depth++;
+					}
+					else if ((nestedEvent == Event::ObjectEnd) || (nestedEvent == Event::ArrayEnd) || (nestedEvent == Event::EndOfDocument)) {
+						depth--;
 					}
+				}
+			}
 
-					default:
-						break;
+			// Reads the next value, an array of numbers that can contain nested arrays, and appends its numbers in order to numbers
+			template <typename T>
+			void readNumberArray(std::vector<T>& numbers) {
+				const Event event = next();
+				if (event != Event::ArrayStart) {
+					skipValue(event);
+
+					return;
+				}
+
+				size_t depth = 1;
+				while (depth != 0) {
+					const Event nestedEvent = next();
+					if (nestedEvent == Event::Number) {
+						numbers.push_back(getNumberAs<T>());
 					}
+					else if (nestedEvent == Event::ArrayStart) {
+						depth++;
+					}
+					else if ((nestedEvent == Event::ArrayEnd) || (nestedEvent == Event::EndOfDocument)) {
+						depth--;
+					}
+					else {
+						skipValue(nestedEvent);
+					}
+				}
+			}
 
-					m_nodes.push_front(node);
-					arrayNode.addObject(&m_nodes.front());
+			// Reads the next value, an array of numbers, into numbers, numbers after maxCount are skipped, returns the number of numbers read
+			template <typename T>
+			size_t readNumberArray(T* numbers, size_t maxCount) {
+				const Event event = next();
+				if (event != Event::ArrayStart) {
+					skipValue(event);
 
-					// Next token is either a comma or an array bracket close
-					if (m_lexer.getNextToken().type == TokenType::ArrayBracketClose) {
-						endOfArray = true;
+					return 0;
+				}
+
+				size_t count = 0;
+				Event elementEvent = next();
+				while ((elementEvent != Event::ArrayEnd) && (elementEvent != Event::EndOfDocument)) {
+					if ((elementEvent == Event::Number) && (count < maxCount)) {
+						numbers[count] = getNumberAs<T>();
+						count++;
 					}
+					else {
+						skipValue(elementEvent);
+					}
+
+					elementEvent = next();
+				}
+
+				return count;
+			}
+
+		private:
+			template <typename T>
+			T getNumberAs() const {
+				if constexpr (std::is_integral_v<T>) {
+					return static_cast<T>(getInt());
+				}
+				else {
+					return static_cast<T>(getNumber());
+				}
+			}
+
+			Token getNextToken() {
+				Token token = m_lexer.getNextToken();
+				while (token.type == TokenType::Incomplete) {
+					refill();
+					token = m_lexer.getNextToken();
+				}
+
+				return token;
+			}
+
+			// Moves the unread data to the front of the buffer and reads the next chunk after it, the buffer grows only for tokens longer than it
+			void refill() {
+				const size_t consumedSize = static_cast<size_t>(m_lexer.getPosition() - m_buffer.data());
+				const size_t remainingSize = m_bufferSize - consumedSize;
+				std::copy(m_buffer.begin() + consumedSize, m_buffer.begin() + m_bufferSize, m_buffer.begin());
+				if (remainingSize == m_buffer.size()) {
+					m_buffer.resize(m_buffer.size() * 2);
+				}
+
+				m_file.read(m_buffer.data() + remainingSize, static_cast<std::streamsize>(m_buffer.size() - remainingSize));
+				m_bufferSize = remainingSize + static_cast<size_t>(m_file.gcount());
+
+				m_lexer.setBuffer(m_buffer.data(), m_buffer.data() + m_bufferSize, m_file.eof());
+			}
+
+			void popContainer() {
+				if (m_containers.empty()) {
+					NTSHENGN_JSON_ERROR("Closing bracket without opening bracket.", Result::JSONError);
 				}
 
-				return arrayNode;
+				m_containers.pop_back();
+				m_expectKey = false;
 			}
 
 		private:
+			static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+			std::ifstream m_file;
+			std::vector<char> m_buffer;
+			size_t m_bufferSize = 0;
 			Lexer m_lexer;
-			
-			std::forward_list<Node> m_nodes;
+
+			// true for objects, false for arrays
+			std::vector<bool> m_containers;
+			bool m_expectKey = false;
+
+			std::string_view m_value;
+		};
+
+	public:
+		// Writes JSON incrementally into a growable buffer or a file, floating-point numbers use their shortest representation that reads back to the same value
+		class Writer {
+		public:
+			// Writes into a buffer, retrieved with getString(), pretty-printed lines are indented by indentationLevel more tabs
+			explicit Writer(bool compact = false, size_t indentationLevel = 0) : m_compact(compact), m_indentationLevel(indentationLevel) {}
+			Writer(const Writer&) = delete;
+			Writer& operator=(const Writer&) = delete;
+
+			~Writer() {
+				close();
+			}
+
+			// Streams into the file at filePath, the buffer is flushed to the file whenever it grows past a chunk, returns false if the file could not be opened
+			bool open(const std::string& filePath) {
+				m_file.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+				return m_file.is_open();
+			}
+
+			void close() {
+				if (m_file.is_open()) {
+					flush();
+					m_file.close();
+				}
+			}
+
+			const std::string& getString() const {
+				return m_buffer;
+			}
+
+			void beginObject() {
+				beginValue();
+				m_buffer += '{';
+				m_containers.push_back({ true, 0 });
+			}
+
+			void endObject() {
+				endContainer('}');
+			}
+
+			void beginArray() {
+				beginValue();
+				m_buffer += '[';
+				m_containers.push_back({ false, 0 });
+			}
+
+			void endArray() {
+				endContainer(']');
+			}
+
+			// Next value is the value of this key
+			void key(std::string_view key) {
+				NTSHENGN_ASSERT(!m_containers.empty() && m_containers.back().isObject);
+
+				beginElement();
+				writeString(key, true);
+				m_buffer += m_compact ? ":" : ": ";
+				m_afterKey = true;
+			}
+
+			void value(std::string_view string) {
+				beginValue();
+				writeString(string, true);
+			}
+
+			void value(const char* string) {
+				value(std::string_view(string));
+			}
+
+			void value(bool boolean) {
+				beginValue();
+				m_buffer += boolean ? "true" : "false";
+			}
+
+			void value(float number) {
+				beginValue();
+				writeNumber(number);
+			}
+
+			void value(double number) {
+				beginValue();
+				writeNumber(number);
+			}
+
+			template <typename T, typename std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+			void value(T number) {
+				beginValue();
+				writeNumber(number);
+			}
+
+			// Writes a node and its children, parsed strings are already escaped
+			void value(const Node& node) {
+				switch (node.getType()) {
+				case Type::Object:
+					beginObject();
+					node.forEachMember([this, &node](std::string_view key, const Node& member) {
+						beginElement();
+						writeString(key, node.isMutable() && (node.m_storage->parsedKeys.find(std::string(key)) == node.m_storage->parsedKeys.end()));
+						m_buffer += m_compact ? ":" : ": ";
+						m_afterKey = true;
+						value(member);
+					});
+					endObject();
+					break;
+
+				case Type::Number:
+					if (node.isInteger()) {
+						value(node.getInt());
+					}
+					else {
+						value(node.getDouble());
+					}
+					break;
+
+				case Type::String:
+					beginValue();
+					writeString(node.getStringView(), node.isMutable());
+					break;
+
+				case Type::Array:
+					beginArray();
+					for (size_t i = 0; i < node.size(); i++) {
+						value(node[i]);
+					}
+					endArray();
+					break;
+
+				case Type::Boolean:
+					value(node.getBoolean());
+					break;
+
+				case Type::Null:
+					null();
+					break;
+
+				default:
+					break;
+				}
+			}
+
+			void null() {
+				beginValue();
+				m_buffer += "null";
+			}
+
+		private:
+			struct Container {
+				bool isObject;
+				size_t elementCount;
+			};
+
+			// Separator and indentation before an object member or an array element
+			void beginElement() {
+				if (m_containers.empty()) {
+					return;
+				}
+
+				Container& container = m_containers.back();
+				if (container.elementCount != 0) {
+					m_buffer += ',';
+				}
+				if (!m_compact) {
+					m_buffer += '\n';
+					m_buffer.append(m_indentationLevel + m_containers.size(), '\t');
+				}
+				container.elementCount++;
+			}
+
+			void beginValue() {
+				if (m_afterKey) {
+					m_afterKey = false;
+				}
+				else {
+					beginElement();
+				}
+
+				if (m_file.is_open() && (m_buffer.size() >= FLUSH_SIZE)) {
+					flush();
+				}
+			}
+
+			void endContainer(char bracket) {
+				NTSHENGN_ASSERT(!m_containers.empty());
+
+				const bool empty = m_containers.back().elementCount == 0;
+				m_containers.pop_back();
+				if (!m_compact && !empty) {
+					m_buffer += '\n';
+					m_buffer.append(m_indentationLevel + m_containers.size(), '\t');
+				}
+				m_buffer += bracket;
+			}
+
+			void writeString(std::string_view string, bool escape) {
+				static const char hexDigits[] = "0123456789abcdef";
+
+				m_buffer += '"';
+				if (!escape) {
+					m_buffer += string;
+				}
+				else {
+					for (const char c : string) {
+						switch (c) {
+						case '"':
+							m_buffer += "\\\"";
+							break;
+
+						case '\\':
+							m_buffer += "\\\\";
+							break;
+
+						case '\n':
+							m_buffer += "\\n";
+							break;
+
+						case '\r':
+							m_buffer += "\\r";
+							break;
+
+						case '\t':
+							m_buffer += "\\t";
+							break;
+
+						default:
+							if (static_cast<unsigned char>(c) < 0x20) {
+								m_buffer += "\\u00";
+								m_buffer += hexDigits[(c >> 4) & 0xF];
+								m_buffer += hexDigits[c & 0xF];
+							}
+							else {
+								m_buffer += c;
+							}
+							break;
+						}
+					}
+				}
+				m_buffer += '"';
+			}
+
+			// std::to_chars without precision writes the shortest representation that round-trips
+			// Standard libraries without floating-point std::to_chars (libc++ before macOS 13.3) search for it with snprintf, from the precision that always round-trips from text
+			template <typename T>
+			void writeNumber(T number) {
+				if constexpr (std::is_floating_point_v<T>) {
+					if (!std::isfinite(number)) {
+						m_buffer += "null";
+
+						return;
+					}
+				}
+
+				char numberString[32];
+#if defined(__cpp_lib_to_chars)
+				const std::to_chars_result result = std::to_chars(numberString, numberString + sizeof(numberString), number);
+				m_buffer.append(numberString, result.ptr);
+#else
+				if constexpr (std::is_floating_point_v<T>) {
+					for (int precision = std::numeric_limits<T>::digits10; precision <= std::numeric_limits<T>::max_digits10; precision++) {
+						const int length = std::snprintf(numberString, sizeof(numberString), "%.*g", precision, static_cast<double>(number));
+						if ((precision == std::numeric_limits<T>::max_digits10) || (static_cast<T>(std::strtod(numberString, nullptr)) == number)) {
+							m_buffer.append(numberString, static_cast<size_t>(length));
+
+							return;
+						}
+					}
+				}
+				else {
+					const std::to_chars_result result = std::to_chars(numberString, numberString + sizeof(numberString), number);
+					m_buffer.append(numberString, result.ptr);
+				}
+#endif
+			}
+
+			void flush() {
+				m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+				m_buffer.clear();
+			}
+
+		private:
+			static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+			bool m_compact;
+			size_t m_indentationLevel;
+			std::string m_buffer;
+			std::ofstream m_file;
+
+			std::vector<Container> m_containers;
+			bool m_afterKey = false;
 		};
 
 	public:
 		Node read(const std::string& filePath) {
-			return m_parser.parse(filePath);
+			return m_parser.parseFile(filePath);
+		}
+
+		Node parse(std::string_view jsonString) {
+			return m_parser.parseString(jsonString);
 		}
 
 	private:
@@ -0,0 +1,211 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace NtshEngn {
+
+	// Bounded lock-free ring buffer queue, each cell carries a sequence number telling producers and consumers whose turn it is (Dmitry Vyukov's design)
+	// Single producer or single consumer sides skip the compare-and-swap on their position
+	template <typename T, bool MultipleProducers, bool MultipleConsumers>
+	class BoundedQueue {
+	public:
+		// capacity is rounded up to the next power of two
+		explicit BoundedQueue(size_t capacity) {
+			m_capacity = 2;
+			while (m_capacity < capacity) {
+				m_capacity *= 2;
+			}
+			m_mask = m_capacity - 1;
+
+			m_cells = new Cell[m_capacity];
+			for (size_t i = 0; i < m_capacity; i++) {
+				m_cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+			m_enqueuePosition.store(0, std::memory_order_relaxed);
+			m_dequeuePosition.store(0, std::memory_order_relaxed);
+		}
+		BoundedQueue(const BoundedQueue&) = delete;
+		BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+		~BoundedQueue() {
+			size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+			while (m_cells[position & m_mask].sequence.load(std::memory_order_relaxed) == (position + 1)) {
+				m_cells[position & m_mask].element()->~T();
+				position++;
+			}
+
+			delete[] m_cells;
+		}
+
+		// Returns false if the queue is full
+		inline bool push_back(const T& element) {
+			return emplace_back(element);
+		}
+
+		inline bool push_back(T&& element) {
+			return emplace_back(std::move(element));
+		}
+
+		template <typename... Args>
+		inline bool emplace_back(Args&&... args) {
+			Cell* cell;
+			size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+			while (true) {
+				cell = &m_cells[position & m_mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+				if (difference == 0) {
+					if constexpr (MultipleProducers) {
+						if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+							break;
+						}
+					}
+					else {
+						m_enqueuePosition.store(position + 1, std::memory_order_relaxed);
+						break;
+					}
+				}
+				else if (difference < 0) { // Full
+					return false;
+				}
+				else {
+					position = m_enqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+
+			new (cell->storage) T(std::forward<Args>(args)...);
+			cell->sequence.store(position + 1, std::memory_order_release);
+
+			// Pairs with the fence in the timed pop_front, either the consumer sees the element or the producer sees the consumer waiting
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (m_waitingConsumers.load(std::memory_order_relaxed) != 0) {
+				std::lock_guard<std::mutex> lock(m_waitMutex);
+				m_waitCondition.notify_one();
+			}
+
+			return true;
+		}
+
+		// Returns false if the queue is empty
+		inline bool pop_front(T& element) {
+			Cell* cell;
+			size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+			while (true) {
+				cell = &m_cells[position & m_mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+				if (difference == 0) {
+					if constexpr (MultipleConsumers) {
+						if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+							break;
+						}
+					}
+					else {
+						m_dequeuePosition.store(position + 1, std::memory_order_relaxed);
+						break;
+					}
+				}
+				else if (difference < 0) { // Empty
+					return false;
+				}
+				else {
+					position = m_dequeuePosition.load(std::memory_order_relaxed);
+				}
+			}
+
+			T* cellElement = cell->element();
+			element = std::move(*cellElement);
+			cellElement->~T();
+			cell->sequence.store(position + m_capacity, std::memory_order_release);
+
+			return true;
+		}
+
+		// Waits up to timeout for an element, returns false if none arrived
+		// Spins briefly for an element about to be pushed, then sleeps until a producer wakes it up
+		template <typename Rep, typename Period>
+		bool pop_front(T& element, const std::chrono::duration<Rep, Period>& timeout) {
+			for (uint32_t spinCount = 0; spinCount < 64; spinCount++) {
+				if (pop_front(element)) {
+					return true;
+				}
+			}
+
+			const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+
+			std::unique_lock<std::mutex> lock(m_waitMutex);
+			m_waitingConsumers.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			bool popped = pop_front(element);
+			while (!popped) {
+				if (m_waitCondition.wait_until(lock, deadline) == std::cv_status::timeout) {
+					popped = pop_front(element);
+					break;
+				}
+				popped = pop_front(element);
+			}
+			m_waitingConsumers.fetch_sub(1, std::memory_order_relaxed);
+
+			return popped;
+		}
+
+		// Approximate when other threads are pushing or popping
+		size_t size() const {
+			const size_t enqueuePosition = m_enqueuePosition.load(std::memory_order_relaxed);
+			const size_t dequeuePosition = m_dequeuePosition.load(std::memory_order_relaxed);
+
+			return (enqueuePosition > dequeuePosition) ? (enqueuePosition - dequeuePosition) : 0;
+		}
+
+		bool empty() const {
+			return size() == 0;
+		}
+
+		size_t capacity() const {
+			return m_capacity;
+		}
+
+	private:
+		struct Cell {
+			std::atomic<size_t> sequence;
+			alignas(T) unsigned char storage[sizeof(T)];
+
+			T* element() {
+				return std::launder(reinterpret_cast<T*>(storage));
+			}
+		};
+
+		static constexpr size_t CACHE_LINE_SIZE = 64;
+
+		alignas(CACHE_LINE_SIZE) Cell* m_cells;
+		size_t m_capacity;
+		size_t m_mask;
+
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_enqueuePosition;
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_dequeuePosition;
+
+		// Consumers blocked in the timed pop_front, producers only take the mutex when there are some
+		alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> m_waitingConsumers{ 0 };
+		std::mutex m_waitMutex;
+		std::condition_variable m_waitCondition;
+	};
+
+	template <typename T>
+	using MPMCQueue = BoundedQueue<T, true, true>;
+
+	template <typename T>
+	using MPSCQueue = BoundedQueue<T, true, false>;
+
+	template <typename T>
+	using SPSCQueue = BoundedQueue<T, false, false>;
+
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#if defined(NTSHENGN_OS_WINDOWS)
+// Only the file mapping functions are needed, without the min and max macros that break std::min and std::max
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#define NTSHENGN_MAPPED_FILE_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#define NTSHENGN_MAPPED_FILE_UNDEF_NOMINMAX
+#endif
+#include <windows.h>
+#if defined(NTSHENGN_MAPPED_FILE_UNDEF_WIN32_LEAN_AND_MEAN)
+#undef WIN32_LEAN_AND_MEAN
+#undef NTSHENGN_MAPPED_FILE_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#if defined(NTSHENGN_MAPPED_FILE_UNDEF_NOMINMAX)
+#undef NOMINMAX
+#undef NTSHENGN_MAPPED_FILE_UNDEF_NOMINMAX
+#endif
+#elif defined(NTSHENGN_OS_LINUX) || defined(NTSHENGN_OS_MACOS)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace NtshEngn {
+
+	// Read-only view of a whole file mapped in memory, pages are read from the disk on first access instead of being copied upfront
+	// On platforms without file mapping, the file is read into memory
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept {
+			*this = std::move(other);
+		}
+		MappedFile& operator=(MappedFile&& other) noexcept {
+			if (this != &other) {
+				close();
+
+				m_data = std::exchange(other.m_data, nullptr);
+				m_size = std::exchange(other.m_size, 0);
+				m_isOpen = std::exchange(other.m_isOpen, false);
+				m_fileContent = std::move(other.m_fileContent);
+			}
+
+			return *this;
+		}
+
+		~MappedFile() {
+			close();
+		}
+
+		// Returns false if the file could not be opened or mapped
+		bool open(const std::string& filePath) {
+			close();
+
+#if defined(NTSHENGN_OS_WINDOWS)
+			const HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize)) {
+				CloseHandle(file);
+
+				return false;
+			}
+			m_size = static_cast<size_t>(fileSize.QuadPart);
+
+			if (m_size != 0) {
+				// The view keeps the mapping alive, both handles can be closed once it is created
+				const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				CloseHandle(file);
+				if (mapping == nullptr) {
+					m_size = 0;
+
+					return false;
+				}
+
+				m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				CloseHandle(mapping);
+				if (m_data == nullptr) {
+					m_size = 0;
+
+					return false;
+				}
+			}
+			else {
+				CloseHandle(file);
+			}
+#elif defined(NTSHENGN_OS_LINUX) || defined(NTSHENGN_OS_MACOS)
+			const int file = ::open(filePath.c_str(), O_RDONLY);
+			if (file == -1) {
+				return false;
+			}
+
+			struct stat fileStat;
+			if (fstat(file, &fileStat) == -1) {
+				::close(file);
+
+				return false;
+			}
+			m_size = static_cast<size_t>(fileStat.st_size);
+
+			if (m_size != 0) {
+				// The mapping stays valid after the file descriptor is closed
+				void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+				::close(file);
+				if (mapping == MAP_FAILED) {
+					m_size = 0;
+
+					return false;
+				}
+
+				m_data = static_cast<const uint8_t*>(mapping);
+			}
+			else {
+				::close(file);
+			}
+#else
+			std::ifstream file(filePath, std::ios::in | std::ios::binary | std::ios::ate);
+			if (!file.is_open()) {
+				return false;
+			}
+			m_size = static_cast<size_t>(file.tellg());
+			m_fileContent.resize(m_size);
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(m_fileContent.data()), static_cast<std::streamsize>(m_size));
+			m_data = m_fileContent.data();
+#endif
+			m_isOpen = true;
+
+			return true;
+		}
+
+		void close() {
+			if (!m_isOpen) {
+				return;
+			}
+
+#if defined(NTSHENGN_OS_WINDOWS)
+			if (m_data != nullptr) {
+				UnmapViewOfFile(m_data);
+			}
+#elif defined(NTSHENGN_OS_LINUX) || defined(NTSHENGN_OS_MACOS)
+			if (m_data != nullptr) {
+				munmap(const_cast<uint8_t*>(m_data), m_size);
+			}
+#else
+			m_fileContent.clear();
+			m_fileContent.shrink_to_fit();
+#endif
+			m_data = nullptr;
+			m_size = 0;
+			m_isOpen = false;
+		}
+
+		// Hints that the range will be read soon so that it is read ahead from the disk
+		void prefetch(size_t offset, size_t size) const {
+			if ((m_data == nullptr) || (offset >= m_size)) {
+				return;
+			}
+			size = std::min(size, m_size - offset);
+
+#if defined(NTSHENGN_OS_LINUX) || defined(NTSHENGN_OS_MACOS)
+			const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+			const size_t pageOffset = offset & ~(pageSize - 1);
+			madvise(const_cast<uint8_t*>(m_data) + pageOffset, size + (offset - pageOffset), MADV_WILLNEED);
+#endif
+		}
+
+		bool isOpen() const {
+			return m_isOpen;
+		}
+
+		const uint8_t* getData() const {
+			return m_data;
+		}
+
+		size_t getSize() const {
+			return m_size;
+		}
+
+	private:
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+		bool m_isOpen = false;
+
+		// Used when file mapping is not available
+		std::vector<uint8_t> m_fileContent;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,402 @@
+#pragma once
+#include "../resources/ntshengn_resources_graphics.h"
+#include "ntshengn_utils_math.h"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace NtshEngn {
+
+	struct VertexCacheStatistics {
+		// Vertices transformed by the vertex shader
+		uint32_t vertexTransformCount = 0;
+
+		// Average cache miss ratio, transformed vertices per triangle, from 0.5 for a perfect grid to 3
+		float acmr = 0.0f;
+
+		// Average transformed vertex ratio, transformed vertices per vertex, 1 is optimal
+		float atvr = 0.0f;
+	};
+
+	// Reorders indexed meshes so that the GPU transforms, shades and fetches less
+	// Vertex cache and overdraw optimizations only apply to triangle lists
+	class MeshOptimizer {
+	public:
+		// Welds duplicate vertices, then reorders triangles for the vertex cache and against overdraw, then reorders vertices for fetch
+		static void optimize(Mesh& mesh, float overdrawThreshold = 1.05f) {
+			weldVertices(mesh);
+			optimizeVertexCache(mesh);
+			optimizeOverdraw(mesh, overdrawThreshold);
+			optimizeVertexFetch(mesh);
+		}
+
+		// Merges vertices whose attributes are bitwise identical, a non-indexed list mesh gets indices
+		// Returns the number of vertices removed
+		static size_t weldVertices(Mesh& mesh) {
+			if (mesh.indices.empty()) {
+				if ((mesh.topology == MeshTopology::TriangleStrip) || (mesh.topology == MeshTopology::LineStrip)) {
+					return 0;
+				}
+
+				mesh.indices.resize(mesh.vertices.size());
+				std::iota(mesh.indices.begin(), mesh.indices.end(), 0);
+			}
+
+			const size_t vertexCount = mesh.vertices.size();
+			size_t tableSize = 1;
+			while (tableSize < (vertexCount * 2)) {
+				tableSize *= 2;
+			}
+			std::vector<uint32_t> table(tableSize, NO_VERTEX);
+			std::vector<uint32_t> remap(vertexCount);
+			std::vector<Vertex> weldedVertices;
+			weldedVertices.reserve(vertexCount);
+			for (size_t i = 0; i < vertexCount; i++) {
+				const Vertex& vertex = mesh.vertices[i];
+				size_t slot = hashVertex(vertex) & (tableSize - 1);
+				while ((table[slot] != NO_VERTEX) && (std::memcmp(&weldedVertices[table[slot]], &vertex, sizeof(Vertex)) != 0)) {
+					slot = (slot + 1) & (tableSize - 1);
+				}
+
+				if (table[slot] == NO_VERTEX) {
+					table[slot] = static_cast<uint32_t>(weldedVertices.size());
+					weldedVertices.push_back(vertex);
+				}
+				remap[i] = table[slot];
+			}
+
+			const size_t removedVertexCount = vertexCount - weldedVertices.size();
+			for (uint32_t& index : mesh.indices) {
+				index = remap[index];
+			}
+			mesh.vertices = std::move(weldedVertices);
+
+			return removedVertexCount;
+		}
+
+		// Reorders triangles so that consecutive triangles share vertices still in the post-transform cache
+		// Tom Forsyth's linear-speed algorithm, vertices are scored by their position in a simulated LRU cache and by how many triangles still use them
+		static void optimizeVertexCache(Mesh& mesh) {
+			if ((mesh.topology != MeshTopology::TriangleList) || (mesh.indices.size() < 6)) {
+				return;
+			}
+
+			const size_t triangleCount = mesh.indices.size() / 3;
+			const size_t vertexCount = mesh.vertices.size();
+
+			// Triangles using each vertex, the ones not emitted yet are kept first
+			std::vector<uint32_t> remainingTriangleCounts(vertexCount, 0);
+			for (size_t i = 0; i < (triangleCount * 3); i++) {
+				remainingTriangleCounts[mesh.indices[i]]++;
+			}
+			std::vector<uint32_t> vertexTriangleOffsets(vertexCount + 1, 0);
+			for (size_t i = 0; i < vertexCount; i++) {
+				vertexTriangleOffsets[i + 1] = vertexTriangleOffsets[i] + remainingTriangleCounts[i];
+			}
+			std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+			{
+				std::vector<uint32_t> vertexTriangleFill(vertexTriangleOffsets.begin(), vertexTriangleOffsets.end() - 1);
+				for (size_t i = 0; i < (triangleCount * 3); i++) {
+					vertexTriangles[vertexTriangleFill[mesh.indices[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			std::vector<int32_t> cachePositions(vertexCount, -1);
+			std::vector<float> vertexScores(vertexCount);
+			for (size_t i = 0; i < vertexCount; i++) {
+				vertexScores[i] = getVertexCacheScore(-1, remainingTriangleCounts[i]);
+			}
+			std::vector<float> triangleScores(triangleCount);
+			std::vector<bool> emittedTriangles(triangleCount, false);
+			uint32_t bestTriangle = 0;
+			for (size_t i = 0; i < triangleCount; i++) {
+				triangleScores[i] = vertexScores[mesh.indices[i * 3]] + vertexScores[mesh.indices[(i * 3) + 1]] + vertexScores[mesh.indices[(i * 3) + 2]];
+				if (triangleScores[i] > triangleScores[bestTriangle]) {
+					bestTriangle = static_cast<uint32_t>(i);
+				}
+			}
+
+			std::vector<uint32_t> cache;
+			cache.reserve(FORSYTH_CACHE_SIZE + 3);
+			std::vector<uint32_t> newCache;
+			newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+			std::vector<uint32_t> optimizedIndices;
+			optimizedIndices.reserve(triangleCount * 3);
+			size_t nextInputTriangle = 0;
+			for (size_t emittedTriangleCount = 0; emittedTriangleCount < triangleCount; emittedTriangleCount++) {
+				// No triangle uses a cached vertex, continue with the next triangle in input order
+				if (bestTriangle == NO_VERTEX) {
+					while (emittedTriangles[nextInputTriangle]) {
+						nextInputTriangle++;
+					}
+					bestTriangle = static_cast<uint32_t>(nextInputTriangle);
+				}
+
+				const std::array<uint32_t, 3> triangle = { mesh.indices[bestTriangle * 3], mesh.indices[(bestTriangle * 3) + 1], mesh.indices[(bestTriangle * 3) + 2] };
+				optimizedIndices.insert(optimizedIndices.end(), triangle.begin(), triangle.end());
+				emittedTriangles[bestTriangle] = true;
+
+				for (uint32_t vertex : triangle) {
+					uint32_t* triangles = vertexTriangles.data() + vertexTriangleOffsets[vertex];
+					uint32_t& remainingTriangleCount = remainingTriangleCounts[vertex];
+					for (uint32_t i = 0; i < remainingTriangleCount; i++) {
+						if (triangles[i] == bestTriangle) {
+							std::swap(triangles[i], triangles[remainingTriangleCount - 1]);
+							remainingTriangleCount--;
+							break;
+						}
+					}
+				}
+
+				// The triangle's vertices move to the front of the cache, vertices pushed past its end are evicted
+				newCache.clear();
+				newCache.insert(newCache.end(), triangle.begin(), triangle.end());
+				for (uint32_t vertex : cache) {
+					if ((vertex != triangle[0]) && (vertex != triangle[1]) && (vertex != triangle[2])) {
+						newCache.push_back(vertex);
+					}
+				}
+				for (size_t i = 0; i < newCache.size(); i++) {
+					const uint32_t vertex = newCache[i];
+					cachePositions[vertex] = (i < FORSYTH_CACHE_SIZE) ? static_cast<int32_t>(i) : -1;
+
+					const float vertexScore = getVertexCacheScore(cachePositions[vertex], remainingTriangleCounts[vertex]);
+					const float scoreDifference = vertexScore - vertexScores[vertex];
+					vertexScores[vertex] = vertexScore;
+					const uint32_t* triangles = vertexTriangles.data() + vertexTriangleOffsets[vertex];
+					for (uint32_t j = 0; j < remainingTriangleCounts[vertex]; j++) {
+						triangleScores[triangles[j]] += scoreDifference;
+					}
+				}
+				newCache.resize(std::min(newCache.size(), FORSYTH_CACHE_SIZE));
+				std::swap(cache, newCache);
+
+				bestTriangle = NO_VERTEX;
+				float bestTriangleScore = -1.0f;
+				for (uint32_t vertex : cache) {
+					const uint32_t* triangles = vertexTriangles.data() + vertexTriangleOffsets[vertex];
+					for (uint32_t j = 0; j < remainingTriangleCounts[vertex]; j++) {
+						if (triangleScores[triangles[j]] > bestTriangleScore) {
+							bestTriangle = triangles[j];
+							bestTriangleScore = triangleScores[triangles[j]];
+						}
+					}
+				}
+			}
+
+			mesh.indices = std::move(optimizedIndices);
+		}
+
+		// Splits the triangles in clusters that keep most of the vertex cache efficiency, then draws the clusters facing outwards first so that they occlude the others
+		// A cluster ends where the cache restarts, or where the ACMR since its start is within threshold of the ACMR of the whole run, as in Sander et al.'s "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+		// Should run after optimizeVertexCache, a threshold of 1.05 allows the ACMR to get 5% worse
+		static void optimizeOverdraw(Mesh& mesh, float threshold = 1.05f) {
+			if ((mesh.topology != MeshTopology::TriangleList) || (mesh.indices.size() < 6)) {
+				return;
+			}
+
+			const size_t triangleCount = mesh.indices.size() / 3;
+
+			// One cache for every pass, reset between clusters, as creating one per cluster costs the mesh's vertex count each time
+			FIFOVertexCache cache(mesh.vertices.size(), OVERDRAW_CACHE_SIZE);
+
+			// Hard boundaries are triangles whose three vertices all miss the cache
+			std::vector<uint32_t> clusterStarts;
+			for (size_t i = 0; i < triangleCount; i++) {
+				const uint32_t misses = cache.access(mesh.indices[i * 3]) + cache.access(mesh.indices[(i * 3) + 1]) + cache.access(mesh.indices[(i * 3) + 2]);
+				if ((i == 0) || (misses == 3)) {
+					clusterStarts.push_back(static_cast<uint32_t>(i));
+				}
+			}
+			clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+			// Soft boundaries split hard clusters wherever the local ACMR is good enough
+			std::vector<uint32_t> softClusterStarts;
+			for (size_t i = 0; (i + 1) < clusterStarts.size(); i++) {
+				const uint32_t start = clusterStarts[i];
+				const uint32_t end = clusterStarts[i + 1];
+
+				cache.reset();
+				uint32_t misses = 0;
+				for (uint32_t j = start; j < end; j++) {
+					misses += cache.access(mesh.indices[j * 3]) + cache.access(mesh.indices[(j * 3) + 1]) + cache.access(mesh.indices[(j * 3) + 2]);
+				}
+				const float clusterACMR = static_cast<float>(misses) / static_cast<float>(end - start);
+
+				cache.reset();
+				softClusterStarts.push_back(start);
+				uint32_t softStart = start;
+				uint32_t softMisses = 0;
+				for (uint32_t j = start; j < end; j++) {
+					softMisses += cache.access(mesh.indices[j * 3]) + cache.access(mesh.indices[(j * 3) + 1]) + cache.access(mesh.indices[(j * 3) + 2]);
+					const float softACMR = static_cast<float>(softMisses) / static_cast<float>(j + 1 - softStart);
+					if (((j + 1) < end) && (softACMR <= (clusterACMR * threshold)) && ((j + 1 - softStart) >= MIN_OVERDRAW_CLUSTER_SIZE)) {
+						cache.reset();
+						softStart = j + 1;
+						softMisses = 0;
+						softClusterStarts.push_back(softStart);
+					}
+				}
+			}
+			softClusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+			// Clusters are sorted by how much they face away from the mesh's center
+			Math::vec3 meshCentroid(0.0f);
+			float meshArea = 0.0f;
+			std::vector<Math::vec3> clusterCentroids(softClusterStarts.size() - 1, Math::vec3(0.0f));
+			std::vector<Math::vec3> clusterNormals(softClusterStarts.size() - 1, Math::vec3(0.0f));
+			std::vector<float> clusterAreas(softClusterStarts.size() - 1, 0.0f);
+			for (size_t i = 0; (i + 1) < softClusterStarts.size(); i++) {
+				for (uint32_t j = softClusterStarts[i]; j < softClusterStarts[i + 1]; j++) {
+					const Math::vec3& p0 = mesh.vertices[mesh.indices[j * 3]].position;
+					const Math::vec3& p1 = mesh.vertices[mesh.indices[(j * 3) + 1]].position;
+					const Math::vec3& p2 = mesh.vertices[mesh.indices[(j * 3) + 2]].position;
+					const Math::vec3 areaNormal = Math::cross(p1 - p0, p2 - p0);
+					const float area = areaNormal.length();
+					const Math::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+					clusterCentroids[i] += centroid * area;
+					clusterNormals[i] += areaNormal;
+					clusterAreas[i] += area;
+					meshCentroid += centroid * area;
+					meshArea += area;
+				}
+			}
+			if (meshArea > 0.0f) {
+				meshCentroid /= meshArea;
+			}
+
+			std::vector<float> clusterSortKeys(clusterCentroids.size());
+			for (size_t i = 0; i < clusterCentroids.size(); i++) {
+				const Math::vec3 centroid = (clusterAreas[i] > 0.0f) ? (clusterCentroids[i] / clusterAreas[i]) : meshCentroid;
+				const float normalLength = clusterNormals[i].length();
+				const Math::vec3 normal = (normalLength > 0.0f) ? (clusterNormals[i] / normalLength) : Math::vec3(0.0f);
+				clusterSortKeys[i] = Math::dot(centroid - meshCentroid, normal);
+			}
+
+			std::vector<uint32_t> clusterOrder(clusterSortKeys.size());
+			std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+			std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&clusterSortKeys](uint32_t a, uint32_t b) {
+				return clusterSortKeys[a] > clusterSortKeys[b];
+			});
+
+			std::vector<uint32_t> optimizedIndices;
+			optimizedIndices.reserve(mesh.indices.size());
+			for (uint32_t cluster : clusterOrder) {
+				optimizedIndices.insert(optimizedIndices.end(), mesh.indices.begin() + (static_cast<size_t>(softClusterStarts[cluster]) * 3), mesh.indices.begin() + (static_cast<size_t>(softClusterStarts[cluster + 1]) * 3));
+			}
+			// Indices past the last whole triangle are kept at the end
+			optimizedIndices.insert(optimizedIndices.end(), mesh.indices.begin() + (triangleCount * 3), mesh.indices.end());
+			mesh.indices = std::move(optimizedIndices);
+		}
+
+		// Reorders vertices in the order the indices first use them so that vertex fetches are sequential, unused vertices are removed
+		static void optimizeVertexFetch(Mesh& mesh) {
+			if (mesh.indices.empty()) {
+				return;
+			}
+
+			std::vector<uint32_t> remap(mesh.vertices.size(), NO_VERTEX);
+			std::vector<Vertex> optimizedVertices;
+			optimizedVertices.reserve(mesh.vertices.size());
+			for (uint32_t& index : mesh.indices) {
+				if (remap[index] == NO_VERTEX) {
+					remap[index] = static_cast<uint32_t>(optimizedVertices.size());
+					optimizedVertices.push_back(mesh.vertices[index]);
+				}
+				index = remap[index];
+			}
+			mesh.vertices = std::move(optimizedVertices);
+		}
+
+		// Simulates a FIFO post-transform cache of cacheSize vertices, as on most GPUs
+		static VertexCacheStatistics analyzeVertexCache(const Mesh& mesh, uint32_t cacheSize = 16) {
+			VertexCacheStatistics statistics;
+			if (mesh.indices.empty() || mesh.vertices.empty()) {
+				return statistics;
+			}
+
+			FIFOVertexCache cache(mesh.vertices.size(), cacheSize);
+			for (uint32_t index : mesh.indices) {
+				statistics.vertexTransformCount += cache.access(index);
+			}
+			statistics.acmr = static_cast<float>(statistics.vertexTransformCount) / static_cast<float>(mesh.indices.size() / 3);
+			statistics.atvr = static_cast<float>(statistics.vertexTransformCount) / static_cast<float>(mesh.vertices.size());
+
+			return statistics;
+		}
+
+	private:
+		static constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+		static constexpr size_t FORSYTH_CACHE_SIZE = 32;
+		static constexpr uint32_t OVERDRAW_CACHE_SIZE = 16;
+		static constexpr uint32_t MIN_OVERDRAW_CLUSTER_SIZE = 8;
+
+		// Vertices timestamped with the miss that brought them in, a vertex is cached while fewer than cacheSize misses happened since
+		class FIFOVertexCache {
+		public:
+			FIFOVertexCache(size_t vertexCount, uint32_t cacheSize) : m_timestamps(vertexCount, 0), m_cacheSize(cacheSize) {}
+
+			// Returns 1 on a miss
+			uint32_t access(uint32_t vertex) {
+				if ((m_timestamps[vertex] != 0) && ((m_time - m_timestamps[vertex]) < m_cacheSize)) {
+					return 0;
+				}
+
+				m_time++;
+				m_timestamps[vertex] = m_time;
+
+				return 1;
+			}
+
+			void reset() {
+				// Moving the clock past every timestamp evicts everything
+				m_time += m_cacheSize;
+			}
+
+		private:
+			std::vector<uint32_t> m_timestamps;
+			uint32_t m_cacheSize;
+			uint32_t m_time = 0;
+		};
+
+		static float getVertexCacheScore(int32_t cachePosition, uint32_t remainingTriangleCount) {
+			if (remainingTriangleCount == 0) {
+				return -1.0f;
+			}
+
+			float score = 0.0f;
+			if (cachePosition >= 0) {
+				// The last triangle's vertices get a fixed score so that triangles using them are not always preferred
+				if (cachePosition < 3) {
+					score = 0.75f;
+				}
+				else {
+					score = std::pow(1.0f - (static_cast<float>(cachePosition - 3) / static_cast<float>(FORSYTH_CACHE_SIZE - 3)), 1.5f);
+				}
+			}
+
+			// Vertices used by few remaining triangles are boosted to finish them and avoid leaving lone triangles behind
+			return score + (2.0f / std::sqrt(static_cast<float>(remainingTriangleCount)));
+		}
+
+		static size_t hashVertex(const Vertex& vertex) {
+			std::array<uint32_t, sizeof(Vertex) / sizeof(uint32_t)> words;
+			std::memcpy(words.data(), &vertex, sizeof(Vertex));
+
+			uint64_t hash = 0xCBF29CE484222325ull;
+			for (uint32_t word : words) {
+				hash = (hash ^ word) * 0x100000001B3ull;
+			}
+
+			return static_cast<size_t>(hash ^ (hash >> 32));
+		}
+	};
+
+}
\ No newline at end of file
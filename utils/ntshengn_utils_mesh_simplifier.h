@@ -0,0 +1,397 @@
+#pragma once
+#include "../resources/ntshengn_resources_graphics.h"
+#include "ntshengn_utils_math.h"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace NtshEngn {
+
+	// Triangle list simplification by edge collapses ordered by quadric error metrics (Garland and Heckbert)
+	// Vertices are collapsed onto other existing vertices so that the simplified indices keep using the mesh's vertices
+	class MeshSimplifier {
+	public:
+		// Returns the indices of a simplified version of the mesh with at most targetIndexCount indices, unless it would exceed targetError
+		// Errors are distances relative to the largest dimension of the mesh's AABB, resultError receives the error of the simplified mesh
+		// Vertices sharing their position with vertices having other attributes (UV or normal seams) are kept, borders only collapse along themselves
+		static std::vector<uint32_t> simplify(const Mesh& mesh, size_t targetIndexCount, float targetError, float* resultError = nullptr) {
+			if (resultError) {
+				*resultError = 0.0f;
+			}
+			if (mesh.topology != MeshTopology::TriangleList) {
+				return mesh.indices;
+			}
+
+			const size_t vertexCount = mesh.vertices.size();
+			std::vector<Math::vec3> positions(vertexCount);
+			Math::vec3 minPosition(std::numeric_limits<float>::max());
+			Math::vec3 maxPosition(std::numeric_limits<float>::lowest());
+			for (const Vertex& vertex : mesh.vertices) {
+				minPosition = Math::vec3(std::min(minPosition.x, vertex.position.x), std::min(minPosition.y, vertex.position.y), std::min(minPosition.z, vertex.position.z));
+				maxPosition = Math::vec3(std::max(maxPosition.x, vertex.position.x), std::max(maxPosition.y, vertex.position.y), std::max(maxPosition.z, vertex.position.z));
+			}
+			const float extent = std::max({ maxPosition.x - minPosition.x, maxPosition.y - minPosition.y, maxPosition.z - minPosition.z, 0.0f });
+			const float scale = (extent > 0.0f) ? (1.0f / extent) : 1.0f;
+			for (size_t i = 0; i < vertexCount; i++) {
+				positions[i] = (mesh.vertices[i].position - minPosition) * scale;
+			}
+
+			std::vector<uint32_t> indices;
+			indices.reserve(mesh.indices.size());
+			for (size_t i = 0; (i + 2) < mesh.indices.size(); i += 3) {
+				const uint32_t a = mesh.indices[i];
+				const uint32_t b = mesh.indices[i + 1];
+				const uint32_t c = mesh.indices[i + 2];
+				if ((a != b) && (b != c) && (c != a)) {
+					indices.insert(indices.end(), { a, b, c });
+				}
+			}
+
+			const std::vector<uint32_t> positionRemap = getPositionRemap(mesh);
+			const std::unordered_set<uint64_t> borderEdges = getBorderEdges(indices, positionRemap);
+			const std::vector<VertexKind> vertexKinds = getVertexKinds(positionRemap, borderEdges);
+
+			// Quadrics are shared by the vertices at the same position
+			std::vector<Quadric> quadrics(vertexCount);
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				const uint32_t triangle[3] = { indices[i], indices[i + 1], indices[i + 2] };
+				const Math::vec3& p0 = positions[triangle[0]];
+				const Math::vec3 areaNormal = Math::cross(positions[triangle[1]] - p0, positions[triangle[2]] - p0);
+				const float doubleArea = areaNormal.length();
+				if (doubleArea == 0.0f) {
+					continue;
+				}
+				const Math::vec3 normal = areaNormal / doubleArea;
+				const Quadric triangleQuadric = Quadric::fromPlane(normal, -Math::dot(normal, p0), doubleArea * 0.5f);
+				for (uint32_t j = 0; j < 3; j++) {
+					quadrics[positionRemap[triangle[j]]] += triangleQuadric;
+
+					// Border edges get a plane perpendicular to the triangle to keep the border in place
+					const uint32_t edgeStart = triangle[j];
+					const uint32_t edgeEnd = triangle[(j + 1) % 3];
+					if (borderEdges.find(getEdgeKey(positionRemap[edgeStart], positionRemap[edgeEnd])) != borderEdges.end()) {
+						const Math::vec3 edge = positions[edgeEnd] - positions[edgeStart];
+						const float edgeLength = edge.length();
+						if (edgeLength > 0.0f) {
+							const Math::vec3 borderNormal = Math::normalize(Math::cross(edge, normal));
+							const Quadric borderQuadric = Quadric::fromPlane(borderNormal, -Math::dot(borderNormal, positions[edgeStart]), edgeLength * edgeLength * BORDER_WEIGHT);
+							quadrics[positionRemap[edgeStart]] += borderQuadric;
+							quadrics[positionRemap[edgeEnd]] += borderQuadric;
+						}
+					}
+				}
+			}
+
+			const double targetErrorSquared = static_cast<double>(targetError) * static_cast<double>(targetError);
+			double maxErrorSquared = 0.0;
+			std::vector<uint32_t> vertexTriangleOffsets(vertexCount + 1);
+			std::vector<uint32_t> vertexTriangles;
+			std::vector<Collapse> collapses;
+			std::vector<uint32_t> collapseTargets(vertexCount);
+			std::vector<bool> lockedVertices(vertexCount);
+			while (indices.size() > targetIndexCount) {
+				buildVertexTriangles(indices, vertexCount, vertexTriangleOffsets, vertexTriangles);
+
+				// Each edge is considered once, in its cheapest direction
+				collapses.clear();
+				for (size_t i = 0; i < indices.size(); i += 3) {
+					for (uint32_t j = 0; j < 3; j++) {
+						const uint32_t start = indices[i + j];
+						const uint32_t end = indices[i + ((j + 1) % 3)];
+						if ((start > end) && ((vertexKinds[start] == VertexKind::Manifold) || (vertexKinds[end] == VertexKind::Manifold) || (borderEdges.find(getEdgeKey(positionRemap[start], positionRemap[end])) == borderEdges.end()))) {
+							// Inner edges are also found from their other triangle
+							continue;
+						}
+
+						Quadric quadric = quadrics[positionRemap[start]];
+						quadric += quadrics[positionRemap[end]];
+						Collapse collapse = { NO_VERTEX, NO_VERTEX, std::numeric_limits<double>::max() };
+						if (canCollapse(start, end, vertexKinds, positionRemap, borderEdges)) {
+							collapse = { start, end, quadric.getError(positions[end]) };
+						}
+						if (canCollapse(end, start, vertexKinds, positionRemap, borderEdges)) {
+							const double error = quadric.getError(positions[start]);
+							if (error < collapse.error) {
+								collapse = { end, start, error };
+							}
+						}
+						if (collapse.from != NO_VERTEX) {
+							collapses.push_back(collapse);
+						}
+					}
+				}
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+					return a.error < b.error;
+				});
+
+				// Collapses in the same pass must not share triangles so that the flip checks stay valid
+				std::iota(collapseTargets.begin(), collapseTargets.end(), 0);
+				std::fill(lockedVertices.begin(), lockedVertices.end(), false);
+				size_t triangleCount = indices.size() / 3;
+				size_t collapseCount = 0;
+				for (const Collapse& collapse : collapses) {
+					if ((collapse.error > targetErrorSquared) || ((triangleCount * 3) <= targetIndexCount)) {
+						break;
+					}
+					if (lockedVertices[collapse.from] || lockedVertices[collapse.to] || flipsTriangles(collapse.from, collapse.to, indices, positions, vertexTriangleOffsets, vertexTriangles)) {
+						continue;
+					}
+
+					collapseTargets[collapse.from] = collapse.to;
+					quadrics[positionRemap[collapse.to]] += quadrics[positionRemap[collapse.from]];
+					maxErrorSquared = std::max(maxErrorSquared, collapse.error);
+					for (uint32_t j = vertexTriangleOffsets[collapse.from]; j < vertexTriangleOffsets[collapse.from + 1]; j++) {
+						const uint32_t triangle = vertexTriangles[j];
+						bool removed = false;
+						for (uint32_t k = 0; k < 3; k++) {
+							lockedVertices[indices[(triangle * 3) + k]] = true;
+							removed = removed || (indices[(triangle * 3) + k] == collapse.to);
+						}
+						if (removed) {
+							triangleCount--;
+						}
+					}
+					collapseCount++;
+				}
+				if (collapseCount == 0) {
+					break;
+				}
+
+				size_t writeIndex = 0;
+				for (size_t i = 0; i < indices.size(); i += 3) {
+					const uint32_t a = collapseTargets[indices[i]];
+					const uint32_t b = collapseTargets[indices[i + 1]];
+					const uint32_t c = collapseTargets[indices[i + 2]];
+					if ((positionRemap[a] != positionRemap[b]) && (positionRemap[b] != positionRemap[c]) && (positionRemap[c] != positionRemap[a])) {
+						indices[writeIndex++] = a;
+						indices[writeIndex++] = b;
+						indices[writeIndex++] = c;
+					}
+				}
+				indices.resize(writeIndex);
+			}
+
+			if (resultError) {
+				*resultError = static_cast<float>(std::sqrt(maxErrorSquared));
+			}
+
+			return indices;
+		}
+
+	private:
+		enum class VertexKind {
+			Manifold,
+			Border,
+			Locked
+		};
+
+		// Symmetric 4x4 matrix of the sum of squared distances to weighted planes
+		struct Quadric {
+			double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+			double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+			double c = 0.0;
+			double weight = 0.0;
+
+			static Quadric fromPlane(const Math::vec3& normal, float distance, float weight) {
+				const double x = static_cast<double>(normal.x);
+				const double y = static_cast<double>(normal.y);
+				const double z = static_cast<double>(normal.z);
+				const double d = static_cast<double>(distance);
+				const double w = static_cast<double>(weight);
+
+				Quadric quadric;
+				quadric.a00 = w * x * x;
+				quadric.a01 = w * x * y;
+				quadric.a02 = w * x * z;
+				quadric.a11 = w * y * y;
+				quadric.a12 = w * y * z;
+				quadric.a22 = w * z * z;
+				quadric.b0 = w * x * d;
+				quadric.b1 = w * y * d;
+				quadric.b2 = w * z * d;
+				quadric.c = w * d * d;
+				quadric.weight = w;
+
+				return quadric;
+			}
+
+			Quadric& operator+=(const Quadric& other) {
+				a00 += other.a00;
+				a01 += other.a01;
+				a02 += other.a02;
+				a11 += other.a11;
+				a12 += other.a12;
+				a22 += other.a22;
+				b0 += other.b0;
+				b1 += other.b1;
+				b2 += other.b2;
+				c += other.c;
+				weight += other.weight;
+
+				return *this;
+			}
+
+			// Weighted average of the squared distances to the planes
+			double getError(const Math::vec3& position) const {
+				const double x = static_cast<double>(position.x);
+				const double y = static_cast<double>(position.y);
+				const double z = static_cast<double>(position.z);
+				const double error = (a00 * x * x) + (a11 * y * y) + (a22 * z * z) + (2.0 * ((a01 * x * y) + (a02 * x * z) + (a12 * y * z))) + (2.0 * ((b0 * x) + (b1 * y) + (b2 * z))) + c;
+
+				return (weight > 0.0) ? (std::abs(error) / weight) : 0.0;
+			}
+		};
+
+		struct Collapse {
+			uint32_t from;
+			uint32_t to;
+			double error;
+		};
+
+		static constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+		static constexpr float BORDER_WEIGHT = 10.0f;
+		// About 75 degrees
+		static constexpr float MAX_NORMAL_ROTATION_COSINE = 0.25f;
+
+		static uint64_t getEdgeKey(uint32_t start, uint32_t end) {
+			return (static_cast<uint64_t>(start) << 32) | static_cast<uint64_t>(end);
+		}
+
+		// Index of the first vertex at each vertex's position
+		static std::vector<uint32_t> getPositionRemap(const Mesh& mesh) {
+			const size_t vertexCount = mesh.vertices.size();
+			size_t tableSize = 1;
+			while (tableSize < (vertexCount * 2)) {
+				tableSize *= 2;
+			}
+			std::vector<uint32_t> table(tableSize, NO_VERTEX);
+			std::vector<uint32_t> positionRemap(vertexCount);
+			for (size_t i = 0; i < vertexCount; i++) {
+				const Math::vec3& position = mesh.vertices[i].position;
+				uint32_t bits[3];
+				std::memcpy(bits, &position, sizeof(bits));
+				uint64_t hash = (static_cast<uint64_t>(bits[0]) * 73856093ull) ^ (static_cast<uint64_t>(bits[1]) * 19349663ull) ^ (static_cast<uint64_t>(bits[2]) * 83492791ull);
+				hash ^= hash >> 29;
+
+				size_t slot = static_cast<size_t>(hash) & (tableSize - 1);
+				while ((table[slot] != NO_VERTEX) && (std::memcmp(&mesh.vertices[table[slot]].position, &position, sizeof(Math::vec3)) != 0)) {
+					slot = (slot + 1) & (tableSize - 1);
+				}
+				if (table[slot] == NO_VERTEX) {
+					table[slot] = static_cast<uint32_t>(i);
+				}
+				positionRemap[i] = table[slot];
+			}
+
+			return positionRemap;
+		}
+
+		// Directed edges between positions that no triangle uses in the opposite direction
+		static std::unordered_set<uint64_t> getBorderEdges(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& positionRemap) {
+			std::unordered_set<uint64_t> edges;
+			edges.reserve(indices.size());
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				for (uint32_t j = 0; j < 3; j++) {
+					edges.insert(getEdgeKey(positionRemap[indices[i + j]], positionRemap[indices[i + ((j + 1) % 3)]]));
+				}
+			}
+
+			std::unordered_set<uint64_t> borderEdges;
+			for (uint64_t edge : edges) {
+				if (edges.find((edge << 32) | (edge >> 32)) == edges.end()) {
+					borderEdges.insert(edge);
+				}
+			}
+
+			return borderEdges;
+		}
+
+		// Seam vertices and vertices on more than one border are locked
+		static std::vector<VertexKind> getVertexKinds(const std::vector<uint32_t>& positionRemap, const std::unordered_set<uint64_t>& borderEdges) {
+			const size_t vertexCount = positionRemap.size();
+			std::vector<uint32_t> positionVertexCounts(vertexCount, 0);
+			for (size_t i = 0; i < vertexCount; i++) {
+				positionVertexCounts[positionRemap[i]]++;
+			}
+
+			std::vector<uint32_t> borderEdgeCounts(vertexCount, 0);
+			for (uint64_t edge : borderEdges) {
+				borderEdgeCounts[static_cast<uint32_t>(edge >> 32)]++;
+				borderEdgeCounts[static_cast<uint32_t>(edge & 0xFFFFFFFF)]++;
+			}
+
+			std::vector<VertexKind> vertexKinds(vertexCount, VertexKind::Manifold);
+			for (size_t i = 0; i < vertexCount; i++) {
+				const uint32_t position = positionRemap[i];
+				if ((positionVertexCounts[position] > 1) || ((borderEdgeCounts[position] != 0) && (borderEdgeCounts[position] != 2))) {
+					vertexKinds[i] = VertexKind::Locked;
+				}
+				else if (borderEdgeCounts[position] == 2) {
+					vertexKinds[i] = VertexKind::Border;
+				}
+			}
+
+			return vertexKinds;
+		}
+
+		static bool canCollapse(uint32_t from, uint32_t to, const std::vector<VertexKind>& vertexKinds, const std::vector<uint32_t>& positionRemap, const std::unordered_set<uint64_t>& borderEdges) {
+			switch (vertexKinds[from]) {
+			case VertexKind::Manifold:
+				return true;
+
+			case VertexKind::Border:
+				// Along the border only, in either direction
+				return (borderEdges.find(getEdgeKey(positionRemap[from], positionRemap[to])) != borderEdges.end()) || (borderEdges.find(getEdgeKey(positionRemap[to], positionRemap[from])) != borderEdges.end());
+
+			default:
+				return false;
+			}
+		}
+
+		static void buildVertexTriangles(const std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>& vertexTriangleOffsets, std::vector<uint32_t>& vertexTriangles) {
+			std::fill(vertexTriangleOffsets.begin(), vertexTriangleOffsets.end(), 0);
+			for (uint32_t index : indices) {
+				vertexTriangleOffsets[index + 1]++;
+			}
+			for (size_t i = 0; i < vertexCount; i++) {
+				vertexTriangleOffsets[i + 1] += vertexTriangleOffsets[i];
+			}
+
+			vertexTriangles.resize(indices.size());
+			std::vector<uint32_t> vertexTriangleFill(vertexTriangleOffsets.begin(), vertexTriangleOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++) {
+				vertexTriangles[vertexTriangleFill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		// Moving from to the position of to must not turn any of from's remaining triangles around or fold them
+		static bool flipsTriangles(uint32_t from, uint32_t to, const std::vector<uint32_t>& indices, const std::vector<Math::vec3>& positions, const std::vector<uint32_t>& vertexTriangleOffsets, const std::vector<uint32_t>& vertexTriangles) {
+			for (uint32_t i = vertexTriangleOffsets[from]; i < vertexTriangleOffsets[from + 1]; i++) {
+				const uint32_t* triangle = indices.data() + (static_cast<size_t>(vertexTriangles[i]) * 3);
+				if ((triangle[0] == to) || (triangle[1] == to) || (triangle[2] == to)) {
+					continue;
+				}
+
+				// Rotate the triangle so that from comes first
+				const uint32_t first = (triangle[0] == from) ? 0 : ((triangle[1] == from) ? 1 : 2);
+				const Math::vec3& p1 = positions[triangle[(first + 1) % 3]];
+				const Math::vec3& p2 = positions[triangle[(first + 2) % 3]];
+				const Math::vec3 normal = Math::cross(p1 - positions[from], p2 - positions[from]);
+				const Math::vec3 collapsedNormal = Math::cross(p1 - positions[to], p2 - positions[to]);
+				if (Math::dot(normal, collapsedNormal) <= (MAX_NORMAL_ROTATION_COSINE * normal.length() * collapsedNormal.length())) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+	};
+
+}
\ No newline at end of file
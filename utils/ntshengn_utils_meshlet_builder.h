@@ -0,0 +1,219 @@
+#pragma once
+#include "../resources/ntshengn_resources_graphics.h"
+#include "ntshengn_utils_math.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace NtshEngn {
+
+	// Splits triangle lists into meshlets, clusters of neighbouring triangles with their own bounds for cluster culling
+	class MeshletBuilder {
+	public:
+		// Replaces mesh's meshlets, meshes that are not indexed triangle lists get none
+		// maxVertexCount is at most 256 as meshlet triangles use 8-bit indices
+		static void build(Mesh& mesh, uint32_t maxVertexCount = 64, uint32_t maxTriangleCount = 124) {
+			mesh.meshlets.clear();
+			mesh.meshletVertices.clear();
+			mesh.meshletTriangles.clear();
+			maxVertexCount = std::min(maxVertexCount, static_cast<uint32_t>(256));
+			if ((mesh.topology != MeshTopology::TriangleList) || (mesh.indices.size() < 3) || (maxVertexCount < 3) || (maxTriangleCount == 0)) {
+				return;
+			}
+
+			const size_t triangleCount = mesh.indices.size() / 3;
+			const size_t vertexCount = mesh.vertices.size();
+
+			std::vector<uint32_t> vertexTriangleOffsets(vertexCount + 1, 0);
+			for (size_t i = 0; i < (triangleCount * 3); i++) {
+				vertexTriangleOffsets[mesh.indices[i] + 1]++;
+			}
+			for (size_t i = 0; i < vertexCount; i++) {
+				vertexTriangleOffsets[i + 1] += vertexTriangleOffsets[i];
+			}
+			std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+			{
+				std::vector<uint32_t> vertexTriangleFill(vertexTriangleOffsets.begin(), vertexTriangleOffsets.end() - 1);
+				for (size_t i = 0; i < (triangleCount * 3); i++) {
+					vertexTriangles[vertexTriangleFill[mesh.indices[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			std::vector<Math::vec3> triangleCentroids(triangleCount);
+			for (size_t i = 0; i < triangleCount; i++) {
+				triangleCentroids[i] = (mesh.vertices[mesh.indices[i * 3]].position + mesh.vertices[mesh.indices[(i * 3) + 1]].position + mesh.vertices[mesh.indices[(i * 3) + 2]].position) / 3.0f;
+			}
+
+			// Index of each vertex in the current meshlet
+			std::vector<uint32_t> localIndices(vertexCount, NO_VERTEX);
+			std::vector<bool> usedTriangles(triangleCount, false);
+			std::vector<uint32_t> candidateTriangles;
+			Meshlet meshlet;
+			meshlet.triangleOffset = 0;
+			Math::vec3 centroidSum(0.0f);
+			size_t nextSeedTriangle = 0;
+			for (size_t addedTriangleCount = 0; addedTriangleCount < triangleCount; addedTriangleCount++) {
+				// Meshlets grow with the neighbouring triangle adding the fewest vertices, then with the one closest to their center
+				uint32_t bestTriangle = NO_VERTEX;
+				uint32_t bestNewVertexCount = 4;
+				float bestDistance = std::numeric_limits<float>::max();
+				const Math::vec3 meshletCentroid = (meshlet.triangleCount != 0) ? (centroidSum / static_cast<float>(meshlet.triangleCount)) : Math::vec3(0.0f);
+				size_t candidateWriteIndex = 0;
+				for (uint32_t triangle : candidateTriangles) {
+					if (usedTriangles[triangle]) {
+						continue;
+					}
+					candidateTriangles[candidateWriteIndex++] = triangle;
+
+					uint32_t newVertexCount = 0;
+					for (uint32_t j = 0; j < 3; j++) {
+						newVertexCount += (localIndices[mesh.indices[(triangle * 3) + j]] == NO_VERTEX) ? 1 : 0;
+					}
+					if ((meshlet.vertexCount + newVertexCount) > maxVertexCount) {
+						continue;
+					}
+
+					const Math::vec3 offset = triangleCentroids[triangle] - meshletCentroid;
+					const float distance = Math::dot(offset, offset);
+					if ((newVertexCount < bestNewVertexCount) || ((newVertexCount == bestNewVertexCount) && (distance < bestDistance))) {
+						bestTriangle = triangle;
+						bestNewVertexCount = newVertexCount;
+						bestDistance = distance;
+					}
+				}
+				candidateTriangles.resize(candidateWriteIndex);
+
+				if (bestTriangle == NO_VERTEX) {
+					// The meshlet is full or has no neighbour left, the next one starts from the first unused triangle
+					if (meshlet.triangleCount != 0) {
+						finishMeshlet(mesh, meshlet, localIndices);
+						meshlet = Meshlet();
+						meshlet.vertexOffset = static_cast<uint32_t>(mesh.meshletVertices.size());
+						meshlet.triangleOffset = static_cast<uint32_t>(mesh.meshletTriangles.size());
+						centroidSum = Math::vec3(0.0f);
+						candidateTriangles.clear();
+					}
+					while (usedTriangles[nextSeedTriangle]) {
+						nextSeedTriangle++;
+					}
+					bestTriangle = static_cast<uint32_t>(nextSeedTriangle);
+				}
+
+				usedTriangles[bestTriangle] = true;
+				centroidSum += triangleCentroids[bestTriangle];
+				for (uint32_t j = 0; j < 3; j++) {
+					const uint32_t vertex = mesh.indices[(bestTriangle * 3) + j];
+					if (localIndices[vertex] == NO_VERTEX) {
+						localIndices[vertex] = meshlet.vertexCount++;
+						mesh.meshletVertices.push_back(vertex);
+						for (uint32_t k = vertexTriangleOffsets[vertex]; k < vertexTriangleOffsets[vertex + 1]; k++) {
+							if (!usedTriangles[vertexTriangles[k]]) {
+								candidateTriangles.push_back(vertexTriangles[k]);
+							}
+						}
+					}
+					mesh.meshletTriangles.push_back(static_cast<uint8_t>(localIndices[vertex]));
+				}
+				meshlet.triangleCount++;
+
+				if (meshlet.triangleCount == maxTriangleCount) {
+					finishMeshlet(mesh, meshlet, localIndices);
+					meshlet = Meshlet();
+					meshlet.vertexOffset = static_cast<uint32_t>(mesh.meshletVertices.size());
+					meshlet.triangleOffset = static_cast<uint32_t>(mesh.meshletTriangles.size());
+					centroidSum = Math::vec3(0.0f);
+					candidateTriangles.clear();
+				}
+			}
+			if (meshlet.triangleCount != 0) {
+				finishMeshlet(mesh, meshlet, localIndices);
+			}
+		}
+
+	private:
+		static constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+		// Cones wider than about 84 degrees cannot cull anything
+		static constexpr float MIN_CONE_NORMAL_COSINE = 0.1f;
+
+		// Computes the meshlet's bounds and adds it to the mesh
+		static void finishMeshlet(Mesh& mesh, Meshlet& meshlet, std::vector<uint32_t>& localIndices) {
+			const uint32_t* vertices = mesh.meshletVertices.data() + meshlet.vertexOffset;
+			for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+				localIndices[vertices[i]] = NO_VERTEX;
+			}
+
+			// Ritter's bounding sphere, started from two distant vertices then grown to include the others
+			const Math::vec3& first = mesh.vertices[vertices[0]].position;
+			Math::vec3 a = first;
+			float maxDistance = -1.0f;
+			for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+				const Math::vec3 offset = mesh.vertices[vertices[i]].position - first;
+				if (Math::dot(offset, offset) > maxDistance) {
+					maxDistance = Math::dot(offset, offset);
+					a = mesh.vertices[vertices[i]].position;
+				}
+			}
+			Math::vec3 b = a;
+			maxDistance = -1.0f;
+			for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+				const Math::vec3 offset = mesh.vertices[vertices[i]].position - a;
+				if (Math::dot(offset, offset) > maxDistance) {
+					maxDistance = Math::dot(offset, offset);
+					b = mesh.vertices[vertices[i]].position;
+				}
+			}
+			Math::vec3 center = (a + b) / 2.0f;
+			float radius = (b - a).length() / 2.0f;
+			for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+				const Math::vec3& position = mesh.vertices[vertices[i]].position;
+				const float distance = (position - center).length();
+				if (distance > radius) {
+					const float newRadius = (radius + distance) / 2.0f;
+					center += (position - center) * ((newRadius - radius) / distance);
+					radius = newRadius;
+				}
+			}
+			meshlet.boundingSphereCenter = center;
+			meshlet.boundingSphereRadius = radius;
+
+			// The cone axis is the average triangle normal, its cutoff is the sine of the largest angle between the axis and a normal
+			const uint8_t* triangles = mesh.meshletTriangles.data() + meshlet.triangleOffset;
+			std::vector<Math::vec3> normals;
+			normals.reserve(meshlet.triangleCount);
+			Math::vec3 normalSum(0.0f);
+			for (uint32_t i = 0; i < meshlet.triangleCount; i++) {
+				const Math::vec3& p0 = mesh.vertices[vertices[triangles[i * 3]]].position;
+				const Math::vec3& p1 = mesh.vertices[vertices[triangles[(i * 3) + 1]]].position;
+				const Math::vec3& p2 = mesh.vertices[vertices[triangles[(i * 3) + 2]]].position;
+				const Math::vec3 normal = Math::cross(p1 - p0, p2 - p0);
+				const float normalLength = normal.length();
+				if (normalLength > 0.0f) {
+					normals.push_back(normal / normalLength);
+					normalSum += normals.back();
+				}
+			}
+
+			meshlet.coneAxis = Math::vec3(0.0f);
+			meshlet.coneCutoff = 1.0f;
+			const float normalSumLength = normalSum.length();
+			if (normalSumLength > 0.0f) {
+				const Math::vec3 axis = normalSum / normalSumLength;
+				float minNormalCosine = 1.0f;
+				for (const Math::vec3& normal : normals) {
+					minNormalCosine = std::min(minNormalCosine, Math::dot(normal, axis));
+				}
+				meshlet.coneAxis = axis;
+				if (minNormalCosine > MIN_CONE_NORMAL_COSINE) {
+					meshlet.coneCutoff = std::sqrt(1.0f - (minNormalCosine * minNormalCosine));
+				}
+			}
+
+			mesh.meshlets.push_back(meshlet);
+		}
+	};
+
+}
\ No newline at end of file
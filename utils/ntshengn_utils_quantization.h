@@ -0,0 +1,147 @@
+#pragma once
+#include "ntshengn_utils_math.h"
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+namespace NtshEngn {
+
+	// Conversions between floats and the compact encodings used by vertex attributes
+	class Quantization {
+	public:
+		// IEEE 754 half-precision, rounds to nearest even, out of range values become infinities
+		static uint16_t floatToHalf(float value) {
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(float));
+
+			const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+			const uint32_t absoluteBits = bits & 0x7FFFFFFF;
+			if (absoluteBits >= 0x7F800000) { // Infinity or NaN
+				return sign | 0x7C00 | ((absoluteBits > 0x7F800000) ? 0x0200 : 0);
+			}
+			if (absoluteBits >= 0x477FF000) { // Rounds to a value larger than the largest half
+				return sign | 0x7C00;
+			}
+			if (absoluteBits < 0x38800000) { // Subnormal half
+				const uint32_t mantissa = (absoluteBits & 0x007FFFFF) | 0x00800000;
+				const uint32_t shift = 126 - (absoluteBits >> 23);
+				if (shift > 24) {
+					return sign;
+				}
+				const uint32_t halfMantissa = mantissa >> shift;
+				const uint32_t remainder = mantissa & ((1u << shift) - 1);
+				const uint32_t halfway = 1u << (shift - 1);
+
+				return sign | static_cast<uint16_t>(halfMantissa + (((remainder > halfway) || ((remainder == halfway) && (halfMantissa & 1))) ? 1 : 0));
+			}
+
+			// Rebias the exponent, then round the 13 dropped mantissa bits, a carry correctly increments the exponent
+			const uint32_t rebiased = absoluteBits - 0x38000000;
+
+			return sign | static_cast<uint16_t>((rebiased + 0x0FFF + ((rebiased >> 13) & 1)) >> 13);
+		}
+
+		static float halfToFloat(uint16_t half) {
+			const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+			const uint32_t exponent = (half >> 10) & 0x1F;
+			uint32_t mantissa = half & 0x03FF;
+
+			uint32_t bits;
+			if (exponent == 0) {
+				if (mantissa == 0) {
+					bits = sign;
+				}
+				else {
+					// Subnormal half, normalized as a float
+					uint32_t floatExponent = 113;
+					while (!(mantissa & 0x0400)) {
+						mantissa <<= 1;
+						floatExponent--;
+					}
+					bits = sign | (floatExponent << 23) | ((mantissa & 0x03FF) << 13);
+				}
+			}
+			else if (exponent == 0x1F) {
+				bits = sign | 0x7F800000 | (mantissa << 13);
+			}
+			else {
+				bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+			}
+
+			float value;
+			std::memcpy(&value, &bits, sizeof(float));
+
+			return value;
+		}
+
+		// Unsigned normalized, [0, 1] maps to [0, 255] or [0, 65535]
+		static uint8_t floatToUnorm8(float value) {
+			return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+		}
+
+		static uint16_t floatToUnorm16(float value) {
+			return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+		}
+
+		static float unorm8ToFloat(uint8_t value) {
+			return static_cast<float>(value) / 255.0f;
+		}
+
+		static float unorm16ToFloat(uint16_t value) {
+			return static_cast<float>(value) / 65535.0f;
+		}
+
+		// Signed normalized, [-1, 1] maps to [-127, 127] or [-32767, 32767]
+		static int8_t floatToSnorm8(float value) {
+			return static_cast<int8_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+		}
+
+		static int16_t floatToSnorm16(float value) {
+			return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+		}
+
+		static float snorm8ToFloat(int8_t value) {
+			return std::max(static_cast<float>(value) / 127.0f, -1.0f);
+		}
+
+		static float snorm16ToFloat(int16_t value) {
+			return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+		}
+
+		// Octahedral encoding of a unit vector, the sphere is projected on an octahedron which is unfolded on a square
+		// Two 16-bit components keep the angular error under 0.005 degrees
+		static std::array<int16_t, 2> encodeOctahedral16(const Math::vec3& direction) {
+			const float l1Norm = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+			if (l1Norm == 0.0f) {
+				return { 0, 0 };
+			}
+
+			float x = direction.x / l1Norm;
+			float y = direction.y / l1Norm;
+			if (direction.z < 0.0f) {
+				const float foldedX = (1.0f - std::abs(y)) * ((x >= 0.0f) ? 1.0f : -1.0f);
+				const float foldedY = (1.0f - std::abs(x)) * ((y >= 0.0f) ? 1.0f : -1.0f);
+				x = foldedX;
+				y = foldedY;
+			}
+
+			return { floatToSnorm16(x), floatToSnorm16(y) };
+		}
+
+		static Math::vec3 decodeOctahedral16(const std::array<int16_t, 2>& encodedDirection) {
+			const float x = snorm16ToFloat(encodedDirection[0]);
+			const float y = snorm16ToFloat(encodedDirection[1]);
+			Math::vec3 direction(x, y, 1.0f - std::abs(x) - std::abs(y));
+			const float fold = std::max(-direction.z, 0.0f);
+			direction.x += (direction.x >= 0.0f) ? -fold : fold;
+			direction.y += (direction.y >= 0.0f) ? -fold : fold;
+
+			const float length = direction.length();
+
+			return (length != 0.0f) ? (direction / length) : direction;
+		}
+	};
+
+}
\ No newline at end of file
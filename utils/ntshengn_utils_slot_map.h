@@ -0,0 +1,216 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <functional>
+#include <new>
+#include <utility>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+
+namespace NtshEngn {
+
+	// Generational reference to an element of a SlotMap<T>, a handle to an erased element stays invalid even if its slot is reused
+	template <typename T>
+	struct Handle {
+		uint32_t index = std::numeric_limits<uint32_t>::max();
+		uint32_t generation = 0;
+
+		bool operator==(const Handle& other) const {
+			return (index == other.index) && (generation == other.generation);
+		}
+
+		bool operator!=(const Handle& other) const {
+			return !(*this == other);
+		}
+	};
+
+	// Unordered storage with O(1) insertion, lookup and erasure through handles, elements never move so pointers to them stay valid until they are erased
+	// Slots are allocated in chunks of doubling size, chunk k holding FIRST_CHUNK_SIZE << k slots
+	template <typename T>
+	class SlotMap {
+	public:
+		SlotMap() = default;
+		SlotMap(const SlotMap&) = delete;
+		SlotMap& operator=(const SlotMap&) = delete;
+
+		~SlotMap() {
+			clear();
+		}
+
+		Handle<T> insert(const T& element) {
+			return emplace(element);
+		}
+
+		Handle<T> insert(T&& element) {
+			return emplace(std::move(element));
+		}
+
+		template <typename... Args>
+		Handle<T> emplace(Args&&... args) {
+			if (m_freeHead == NO_FREE_SLOT) {
+				const uint32_t chunkSize = FIRST_CHUNK_SIZE << m_chunks.size();
+				m_chunks.emplace_back(new Slot[chunkSize]);
+				// Chain the new slots so that the lowest index is used first
+				const uint32_t firstIndex = m_capacity;
+				for (uint32_t i = 0; i < chunkSize; i++) {
+					m_chunks.back()[i].nextFree = (i + 1 < chunkSize) ? (firstIndex + i + 1) : NO_FREE_SLOT;
+				}
+				m_freeHead = firstIndex;
+				m_capacity += chunkSize;
+			}
+
+			const uint32_t index = m_freeHead;
+			Slot& slot = getSlot(index);
+			new (slot.storage) T(std::forward<Args>(args)...);
+			m_freeHead = slot.nextFree;
+			slot.index = index;
+			slot.alive = true;
+			m_size++;
+
+			return { index, slot.generation };
+		}
+
+		// Returns false if the handle does not refer to an element
+		bool erase(Handle<T> handle) {
+			if (!exist(handle)) {
+				return false;
+			}
+
+			Slot& slot = getSlot(handle.index);
+			slot.element()->~T();
+			slot.alive = false;
+			slot.generation++;
+			slot.nextFree = m_freeHead;
+			m_freeHead = handle.index;
+			m_size--;
+
+			return true;
+		}
+
+		bool exist(Handle<T> handle) const {
+			if (handle.index >= m_capacity) {
+				return false;
+			}
+
+			const Slot& slot = getSlot(handle.index);
+
+			return slot.alive && (slot.generation == handle.generation);
+		}
+
+		// Returns nullptr if the handle does not refer to an element
+		T* get(Handle<T> handle) {
+			return exist(handle) ? getSlot(handle.index).element() : nullptr;
+		}
+
+		const T* get(Handle<T> handle) const {
+			return exist(handle) ? getSlot(handle.index).element() : nullptr;
+		}
+
+		// Handle of an element of this map, an invalid handle if element is not one
+		// The element's chunk is found among at most 32 chunks, the slot is then known from the address
+		Handle<T> getHandle(const T* element) const {
+			const std::byte* address = reinterpret_cast<const std::byte*>(element);
+			for (size_t chunk = 0; chunk < m_chunks.size(); chunk++) {
+				const std::byte* chunkBegin = reinterpret_cast<const std::byte*>(m_chunks[chunk].get());
+				const std::byte* chunkEnd = chunkBegin + (sizeof(Slot) * (static_cast<size_t>(FIRST_CHUNK_SIZE) << chunk));
+				if (std::less<const std::byte*>()(address, chunkBegin) || !std::less<const std::byte*>()(address, chunkEnd)) {
+					continue;
+				}
+
+				const size_t slotOffset = static_cast<size_t>(address - chunkBegin);
+				if ((slotOffset % sizeof(Slot)) != 0) {
+					return {};
+				}
+
+				const Slot& slot = m_chunks[chunk][slotOffset / sizeof(Slot)];
+				if (!slot.alive) {
+					return {};
+				}
+
+				return { slot.index, slot.generation };
+			}
+
+			return {};
+		}
+
+		void clear() {
+			for (size_t chunk = 0; chunk < m_chunks.size(); chunk++) {
+				const uint32_t chunkSize = FIRST_CHUNK_SIZE << chunk;
+				for (uint32_t i = 0; i < chunkSize; i++) {
+					Slot& slot = m_chunks[chunk][i];
+					if (slot.alive) {
+						slot.element()->~T();
+					}
+				}
+			}
+			m_chunks.clear();
+			m_capacity = 0;
+			m_size = 0;
+			m_freeHead = NO_FREE_SLOT;
+		}
+
+		size_t size() const {
+			return static_cast<size_t>(m_size);
+		}
+
+		bool empty() const {
+			return m_size == 0;
+		}
+
+		// Calls function on every element, function must not insert or erase elements
+		void for_each(const std::function<void(Handle<T>, T&)>& function) {
+			for (size_t chunk = 0; chunk < m_chunks.size(); chunk++) {
+				const uint32_t chunkSize = FIRST_CHUNK_SIZE << chunk;
+				for (uint32_t i = 0; i < chunkSize; i++) {
+					Slot& slot = m_chunks[chunk][i];
+					if (slot.alive) {
+						function({ slot.index, slot.generation }, *slot.element());
+					}
+				}
+			}
+		}
+
+	private:
+		struct Slot {
+			alignas(T) unsigned char storage[sizeof(T)];
+			uint32_t index = 0;
+			uint32_t generation = 0;
+			uint32_t nextFree = 0;
+			bool alive = false;
+
+			T* element() {
+				return std::launder(reinterpret_cast<T*>(storage));
+			}
+
+			const T* element() const {
+				return std::launder(reinterpret_cast<const T*>(storage));
+			}
+		};
+
+		static constexpr uint32_t FIRST_CHUNK_SIZE = 64;
+		static constexpr uint32_t NO_FREE_SLOT = std::numeric_limits<uint32_t>::max();
+
+		// Chunk k starts at index FIRST_CHUNK_SIZE * (2^k - 1)
+		Slot& getSlot(uint32_t index) {
+			return const_cast<Slot&>(static_cast<const SlotMap*>(this)->getSlot(index));
+		}
+
+		const Slot& getSlot(uint32_t index) const {
+			const uint32_t scaledIndex = (index / FIRST_CHUNK_SIZE) + 1;
+			uint32_t chunk = 0;
+			while ((scaledIndex >> (chunk + 1)) != 0) {
+				chunk++;
+			}
+
+			return m_chunks[chunk][index - (FIRST_CHUNK_SIZE * ((1u << chunk) - 1))];
+		}
+
+	private:
+		std::vector<std::unique_ptr<Slot[]>> m_chunks;
+		uint32_t m_capacity = 0;
+		uint32_t m_size = 0;
+		uint32_t m_freeHead = NO_FREE_SLOT;
+	};
+
+}
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
+#include <utility>
+#include <cstddef>
 
 namespace NtshEngn {
 
@@ -16,13 +19,41 @@ namespace NtshEngn {
 			lock.unlock();
 		}
 
+		inline void push_back(T&& element) {
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			m_queue.push(std::move(element));
+
+			lock.unlock();
+		}
+
+		template <typename... Args>
+		inline void emplace_back(Args&&... args) {
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			m_queue.emplace(std::forward<Args>(args)...);
+
+			lock.unlock();
+		}
+
+		// Moves count elements into the queue under a single lock
+		inline void push_bulk(T* elements, size_t count) {
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			for (size_t i = 0; i < count; i++) {
+				m_queue.push(std::move(elements[i]));
+			}
+
+			lock.unlock();
+		}
+
 		inline bool pop_front(T& element) {
 			std::unique_lock<std::mutex> lock(m_mutex);
 
 			bool result = false;
 
 			if (!m_queue.empty()) {
-				element = m_queue.front();
+				element = std::move(m_queue.front());
 				m_queue.pop();
 
 				result = true;
@@ -36,6 +67,23 @@ namespace NtshEngn {
 			return result;
 		}
 
+		// Moves up to maxCount elements to the back of elements under a single lock, returns the number of elements popped
+		inline size_t pop_bulk(std::vector<T>& elements, size_t maxCount) {
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			size_t count = 0;
+			while (!m_queue.empty() && (count < maxCount)) {
+				elements.push_back(std::move(m_queue.front()));
+				m_queue.pop();
+
+				count++;
+			}
+
+			lock.unlock();
+
+			return count;
+		}
+
 	private:
 		std::queue<T> m_queue;
 